@@ -0,0 +1,219 @@
+#include <algorithm>
+#include <cstdlib>
+#include <format>
+#include <new>
+
+#include "bench.hpp"
+
+namespace
+{
+
+// NOLINTBEGIN(*non-const-global*)
+thread_local std::size_t alloc_count = 0;
+thread_local std::size_t alloc_bytes = 0;
+// NOLINTEND(*non-const-global*)
+
+void* allocate(std::size_t size, std::size_t align)
+{
+  alloc_count++;
+  alloc_bytes += size;
+
+  if (size == 0) {
+    size = 1;
+  }
+
+  void* ptr = align <= alignof(std::max_align_t)
+      ? std::malloc(size)  // NOLINT(*no-malloc*)
+      : std::aligned_alloc(align, (size + align - 1) / align * align);
+  if (ptr == nullptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+using clock_type = std::chrono::steady_clock;
+
+double measure(const std::function<void()>& func, std::size_t iterations)
+{
+  const auto start = clock_type::now();
+  for (std::size_t i = 0; i < iterations; i++) {
+    func();
+  }
+  const auto end = clock_type::now();
+  return std::chrono::duration<double, std::nano>(end - start).count();
+}
+
+std::string escape_json(std::string_view str)
+{
+  std::string res;
+  for (const auto chr : str) {
+    if (chr == '"' || chr == '\\') {
+      res += '\\';
+    }
+    res += chr;
+  }
+  return res;
+}
+
+// an allocation figure, or the placeholder when operator new does not see them
+std::string format_allocs(
+    const poafloc::bench::result& res, double value, std::string_view unseen
+)
+{
+  if (res.allocs == poafloc::bench::heap::unseen) {
+    return std::string(unseen);
+  }
+  return std::format("{:.3f}", value);
+}
+
+}  // namespace
+
+// NOLINTBEGIN(*no-malloc*, *owning-memory*)
+void* operator new(std::size_t size)
+{
+  return allocate(size, alignof(std::max_align_t));
+}
+
+void* operator new(std::size_t size, std::align_val_t align)
+{
+  return allocate(size, static_cast<std::size_t>(align));
+}
+
+void operator delete(void* ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t /* size */) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t /* align */) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(
+    void* ptr, std::size_t /* size */, std::align_val_t /* align */
+) noexcept
+{
+  std::free(ptr);
+}
+// NOLINTEND(*no-malloc*, *owning-memory*)
+
+namespace poafloc::bench
+{
+
+allocations allocation_snapshot()
+{
+  return {alloc_count, alloc_bytes};
+}
+
+std::vector<result> suite::run(
+    std::string_view filter, std::chrono::milliseconds min_time
+) const
+{
+  static constexpr const auto batch_time = 10'000'000.0;  // 10ms
+  static constexpr const auto batches = 5;
+
+  std::vector<result> results;
+  for (const auto& [name, items, func, allocs] : m_entries) {
+    if (name.find(filter) == std::string::npos) {
+      continue;
+    }
+
+    // warm up and find the number of iterations filling one batch
+    std::size_t iterations = 1;
+    while (measure(func, iterations) < batch_time) {
+      iterations *= 2;
+    }
+
+    // best batch wins, everything above it is noise
+    auto best = measure(func, iterations);
+    const auto deadline = clock_type::now() + min_time;
+    for (int i = 1; i < batches || clock_type::now() < deadline; i++) {
+      best = std::min(best, measure(func, iterations));
+    }
+
+    const auto before = allocation_snapshot();
+    func();
+    const auto after = allocation_snapshot();
+
+    const auto total = static_cast<double>(iterations * items);
+    const auto per_call = static_cast<double>(items);
+    results.push_back({
+        .name = name,
+        .iterations = iterations,
+        .items = items,
+        .ns_per_item = best / total,
+        .allocs_per_item =
+            static_cast<double>(after.count - before.count) / per_call,
+        .bytes_per_item =
+            static_cast<double>(after.bytes - before.bytes) / per_call,
+        .allocs = allocs,
+    });
+  }
+
+  return results;
+}
+
+void report_json(std::ostream& ost, const std::vector<result>& results)
+{
+  ost << "{\n  \"benchmarks\": [";
+  const char* sep = "\n";
+  for (const auto& res : results) {
+    ost << sep;
+    ost << std::format(
+        "    {{\"name\": \"{}\", \"iterations\": {}, \"items\": {}, "
+        "\"ns_per_item\": {:.3f}, \"allocs_per_item\": {}, "
+        "\"bytes_per_item\": {}}}",
+        escape_json(res.name),
+        res.iterations,
+        res.items,
+        res.ns_per_item,
+        format_allocs(res, res.allocs_per_item, "null"),
+        format_allocs(res, res.bytes_per_item, "null")
+    );
+    sep = ",\n";
+  }
+  ost << "\n  ]\n}\n";
+}
+
+void report_csv(std::ostream& ost, const std::vector<result>& results)
+{
+  ost << "name,iterations,items,ns_per_item,allocs_per_item,bytes_per_item\n";
+  for (const auto& res : results) {
+    ost << std::format(
+        "{},{},{},{:.3f},{},{}\n",
+        res.name,
+        res.iterations,
+        res.items,
+        res.ns_per_item,
+        format_allocs(res, res.allocs_per_item, "n/a"),
+        format_allocs(res, res.bytes_per_item, "n/a")
+    );
+  }
+}
+
+void report_text(std::ostream& ost, const std::vector<result>& results)
+{
+  ost << std::format(
+      "{:<40} {:>12} {:>12} {:>12}\n",
+      "benchmark",
+      "ns/item",
+      "allocs/item",
+      "bytes/item"
+  );
+  for (const auto& res : results) {
+    ost << std::format(
+        "{:<40} {:>12.3f} {:>12} {:>12}\n",
+        res.name,
+        res.ns_per_item,
+        format_allocs(res, res.allocs_per_item, "n/a"),
+        format_allocs(res, res.bytes_per_item, "n/a")
+    );
+  }
+}
+
+}  // namespace poafloc::bench
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace poafloc::bench
+{
+
+struct allocations
+{
+  std::size_t count = 0;
+  std::size_t bytes = 0;
+};
+
+// Allocations done by the calling thread since the start of the program, as
+// seen by the replaced global operator new
+allocations allocation_snapshot();
+
+template<class T>
+void do_not_optimize(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "r,m"(value) : "memory");
+#else
+  static volatile const void* sink = nullptr;
+  sink = &value;
+#endif
+}
+
+// whether the allocations of a benchmark go through operator new, those made
+// with malloc by the C library are not seen and are reported as n/a
+enum class heap : bool
+{
+  counted,
+  unseen,
+};
+
+struct result
+{
+  std::string name;
+  std::size_t iterations = 0;
+  std::size_t items = 0;
+  double ns_per_item = 0;
+  double allocs_per_item = 0;
+  double bytes_per_item = 0;
+  heap allocs = heap::counted;
+};
+
+class suite
+{
+  struct entry
+  {
+    std::string name;
+    std::size_t items;
+    std::function<void()> func;
+    heap allocs;
+  };
+
+  std::vector<entry> m_entries;
+
+public:
+  // items is the number of processed units (usually arguments) per call
+  template<class Func>
+  void add(
+      std::string name,
+      std::size_t items,
+      Func func,
+      heap allocs = heap::counted
+  )
+  {
+    m_entries.emplace_back(std::move(name), items, std::move(func), allocs);
+  }
+
+  [[nodiscard]] std::vector<result> run(
+      std::string_view filter, std::chrono::milliseconds min_time
+  ) const;
+};
+
+void report_json(std::ostream& ost, const std::vector<result>& results);
+void report_csv(std::ostream& ost, const std::vector<result>& results);
+void report_text(std::ostream& ost, const std::vector<result>& results);
+
+// benchmark registration, one per source file
+void register_command(suite& benchmarks);
+void register_compare(suite& benchmarks);  // only where argp is available
+void register_config(suite& benchmarks);
+void register_convert(suite& benchmarks);
+void register_environment(suite& benchmarks);
+void register_lazy(suite& benchmarks);
+void register_option(suite& benchmarks);
+void register_parser(suite& benchmarks);
+void register_response(suite& benchmarks);
+void register_tokenizer(suite& benchmarks);
+void register_trie(suite& benchmarks);
+
+}  // namespace poafloc::bench
@@ -0,0 +1,111 @@
+#include <array>
+#include <cstddef>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <poafloc/command.hpp>
+#include <poafloc/poafloc.hpp>
+
+#include "bench.hpp"
+
+namespace
+{
+
+struct record
+{
+  // NOLINTBEGIN(*non-private*)
+  bool flag = false;
+  int number = 0;
+  std::size_t count = 0;
+  // NOLINTEND(*non-private*)
+
+  void set(std::string_view value) { count += std::size(value); }
+};
+
+auto make_parser()
+{
+  using poafloc::boolean;
+  using poafloc::direct;
+  using poafloc::group;
+
+  return poafloc::parser<record> {
+      group {
+          "unnamed",
+          boolean {"f flag", &record::flag, "Flag"},
+          direct {"n name", &record::set, "NAME Name"},
+          direct {"i integer", &record::number, "NUM Integer"},
+          direct {"output", &record::set, "FILE Output"},
+          direct {"verbose", &record::set, "LEVEL Verbosity"},
+      },
+  };
+}
+
+constexpr std::size_t count = 32;
+
+constexpr auto names = []
+{
+  std::array<std::array<char, 6>, count> res = {};
+  for (std::size_t i = 0; i < count; i++) {
+    res[i] = {'c', 'm', 'd', static_cast<char>('0' + (i / 10)),
+              static_cast<char>('0' + (i % 10)), '\0'};
+  }
+  return res;
+}();
+
+template<std::size_t Idx>
+constexpr auto make_command()
+{
+  return poafloc::command {
+      std::string_view(names[Idx].data()),
+      [] { return make_parser(); },
+      [](record& rec) { return rec.number; },
+      "Subcommand",
+  };
+}
+
+constexpr auto cli = []<std::size_t... Idx>(std::index_sequence<Idx...>)
+{
+  return poafloc::commands {make_command<Idx>()...};
+}(std::make_index_sequence<count> {});
+
+const std::vector<const char*> argv = {"tool", "cmd17", "-f", "-i", "42"};
+
+}  // namespace
+
+namespace poafloc::bench
+{
+
+void register_command(suite& benchmarks)
+{
+  // one run of a multi-tool binary: only the selected parser is built
+  benchmarks.add(
+      "command/lazy",
+      1,
+      []()
+      {
+        const auto res = cli(static_cast<int>(std::size(argv)), argv.data());
+        do_not_optimize(res);
+      }
+  );
+
+  // every subcommand's parser built up front, as without subcommands
+  benchmarks.add(
+      "command/eager",
+      1,
+      []()
+      {
+        std::vector<parser<record>> parsers;
+        parsers.reserve(count);
+        for (std::size_t i = 0; i < count; i++) {
+          parsers.push_back(make_parser());
+        }
+
+        record rec;
+        parsers[17](rec, static_cast<int>(std::size(argv)) - 1, &argv[1]);
+        do_not_optimize(rec);
+      }
+  );
+}
+
+}  // namespace poafloc::bench
@@ -0,0 +1,373 @@
+#include <array>
+#include <cerrno>
+#include <charconv>
+#include <cstddef>
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <argp.h>
+#include <getopt.h>
+#include <poafloc/poafloc.hpp>
+
+#include "bench.hpp"
+
+// The same options and the same command lines, through poafloc and through
+// the glibc parsers it replaces. Options are in front of the files in every
+// corpus, so neither getopt_long nor argp has to permute argv, and all three
+// agree on what is an option. Allocations are counted by operator new, the
+// ones that glibc makes with malloc, such as argp's per call, are not seen, so
+// getopt_long and argp report theirs as n/a rather than as none.
+
+namespace
+{
+
+struct options
+{
+  // NOLINTBEGIN(*non-private*)
+  bool all = false;
+  bool brief = false;
+  bool color = false;
+  int integer = 0;
+  std::string_view name;
+  std::string_view verbose;
+  std::string_view version;
+  std::string_view variable;
+  std::string_view output;
+  std::string_view outputfile;
+  std::size_t files = 0;
+  std::size_t length = 0;
+  // NOLINTEND(*non-private*)
+
+  // the files are read by all of them, as a tool would open them
+  void add(std::string_view file)
+  {
+    files++;
+    length += std::size(file);
+  }
+
+  bool operator==(const options&) const = default;
+};
+
+bool to_int(const char* value, int& out)
+{
+  const auto text = std::string_view(value);
+  const auto* end = text.data() + std::size(text);  // NOLINT(*pointer*)
+  const auto [ptr, err] = std::from_chars(text.data(), end, out);
+  return err == std::errc {} && ptr == end;
+}
+
+// poafloc
+
+auto make_poafloc()
+{
+  using poafloc::argument_list;
+  using poafloc::boolean;
+  using poafloc::direct;
+  using poafloc::group;
+  using poafloc::positional;
+
+  return poafloc::parser<options> {
+      positional {
+          argument_list {"files", &options::add},
+      },
+      group {
+          "options",
+          boolean {"a all", &options::all, "Flag a"},
+          boolean {"b brief", &options::brief, "Flag b"},
+          boolean {"c color", &options::color, "Flag c"},
+          direct {"n name", &options::name, "NAME Name"},
+          direct {"i integer", &options::integer, "NUM Integer"},
+          direct {"verbose", &options::verbose, "LEVEL Verbosity"},
+          direct {"version", &options::version, "VER Version"},
+          direct {"variable", &options::variable, "VAR Variable"},
+          direct {"output", &options::output, "FILE Output"},
+          direct {"outputfile", &options::outputfile, "FILE Output file"},
+      },
+  };
+}
+
+// getopt_long and argp share the keys of the long only options
+
+enum key : int
+{
+  key_verbose = 256,
+  key_version,
+  key_variable,
+  key_output,
+  key_outputfile,
+};
+
+bool set(options& rec, int key, const char* arg)
+{
+  switch (key) {
+    case 'a':
+      rec.all = true;
+      break;
+    case 'b':
+      rec.brief = true;
+      break;
+    case 'c':
+      rec.color = true;
+      break;
+    case 'n':
+      rec.name = arg;
+      break;
+    case 'i':
+      return to_int(arg, rec.integer);
+    case key_verbose:
+      rec.verbose = arg;
+      break;
+    case key_version:
+      rec.version = arg;
+      break;
+    case key_variable:
+      rec.variable = arg;
+      break;
+    case key_output:
+      rec.output = arg;
+      break;
+    case key_outputfile:
+      rec.outputfile = arg;
+      break;
+    default:
+      return false;
+  }
+  return true;
+}
+
+// getopt_long, stopping at the first file as poafloc does
+
+constexpr std::array<option, 11> long_options = {{
+    {"all", no_argument, nullptr, 'a'},
+    {"brief", no_argument, nullptr, 'b'},
+    {"color", no_argument, nullptr, 'c'},
+    {"name", required_argument, nullptr, 'n'},
+    {"integer", required_argument, nullptr, 'i'},
+    {"verbose", required_argument, nullptr, key_verbose},
+    {"version", required_argument, nullptr, key_version},
+    {"variable", required_argument, nullptr, key_variable},
+    {"output", required_argument, nullptr, key_output},
+    {"outputfile", required_argument, nullptr, key_outputfile},
+    {nullptr, 0, nullptr, 0},
+}};
+
+bool parse_getopt(options& rec, int argc, char** argv)
+{
+  // zero starts a new scan, resetting the state kept in between calls
+  optind = 0;
+  opterr = 0;
+
+  int key = 0;
+  while ((key = getopt_long(
+              argc, argv, "+abcn:i:", long_options.data(), nullptr
+          ))
+         != -1)
+  {
+    if (!set(rec, key, optarg)) {
+      return false;
+    }
+  }
+
+  for (int i = optind; i < argc; i++) {
+    rec.add(argv[i]);  // NOLINT(*pointer*)
+  }
+  return true;
+}
+
+// argp, handing over the files in order
+
+error_t parse_argp_opt(int key, char* arg, argp_state* state)
+{
+  auto& rec = *static_cast<options*>(state->input);
+  if (key == ARGP_KEY_ARG) {
+    rec.add(arg);
+    return 0;
+  }
+
+  // the special keys that follow ARGP_KEY_END need no handling
+  if (key >= ARGP_KEY_END) {
+    return ARGP_ERR_UNKNOWN;
+  }
+
+  return set(rec, key, arg) ? 0 : EINVAL;
+}
+
+constexpr std::array<argp_option, 11> argp_options = {{
+    {"all", 'a', nullptr, 0, "Flag a", 0},
+    {"brief", 'b', nullptr, 0, "Flag b", 0},
+    {"color", 'c', nullptr, 0, "Flag c", 0},
+    {"name", 'n', "NAME", 0, "Name", 0},
+    {"integer", 'i', "NUM", 0, "Integer", 0},
+    {"verbose", key_verbose, "LEVEL", 0, "Verbosity", 0},
+    {"version", key_version, "VER", 0, "Version", 0},
+    {"variable", key_variable, "VAR", 0, "Variable", 0},
+    {"output", key_output, "FILE", 0, "Output", 0},
+    {"outputfile", key_outputfile, "FILE", 0, "Output file", 0},
+    {},
+}};
+
+const argp argp_parser = {
+    argp_options.data(),
+    parse_argp_opt,
+    "FILE...",
+    nullptr,
+    nullptr,
+    nullptr,
+    nullptr,
+};
+
+bool parse_argp(options& rec, int argc, char** argv)
+{
+  static constexpr unsigned flags = ARGP_SILENT | ARGP_IN_ORDER;
+  return argp_parse(&argp_parser, argc, argv, flags, nullptr, &rec) == 0;
+}
+
+// command line owning its arguments, as main receives it
+class corpus
+{
+  std::vector<std::string> m_storage;
+  std::vector<char*> m_argv;
+
+public:
+  explicit corpus(std::vector<std::string> args)
+      : m_storage(std::move(args))
+  {
+    m_argv.reserve(std::size(m_storage) + 1);
+    for (auto& arg : m_storage) {
+      m_argv.push_back(arg.data());
+    }
+    m_argv.push_back(nullptr);
+  }
+
+  [[nodiscard]] int argc() const
+  {
+    return static_cast<int>(std::size(m_storage));
+  }
+
+  [[nodiscard]] char** argv() { return m_argv.data(); }
+  [[nodiscard]] std::size_t items() const { return std::size(m_storage) - 1; }
+};
+
+std::vector<std::string> repeat(
+    std::initializer_list<std::string> args, std::size_t cnt
+)
+{
+  std::vector<std::string> res = {"bench"};
+  for (std::size_t i = 0; i < cnt; i++) {
+    res.insert(res.end(), args);
+  }
+  return res;
+}
+
+std::vector<std::string> with_files(
+    std::vector<std::string> head, std::size_t cnt
+)
+{
+  for (std::size_t i = 0; i < cnt; i++) {
+    head.push_back("source_" + std::to_string(i) + ".c");
+  }
+  return head;
+}
+
+template<class Func>
+void add_compare(
+    poafloc::bench::suite& benchmarks,
+    const std::string& name,
+    corpus& args,
+    Func func,
+    poafloc::bench::heap allocs
+)
+{
+  benchmarks.add(
+      name,
+      args.items(),
+      [&args, func]()
+      {
+        options rec;
+        poafloc::bench::do_not_optimize(func(rec, args));
+        poafloc::bench::do_not_optimize(rec);
+      },
+      allocs
+  );
+}
+
+}  // namespace
+
+namespace poafloc::bench
+{
+
+void register_compare(suite& benchmarks)
+{
+  static const auto program = make_poafloc();
+
+  benchmarks.add(
+      "compare/construct/poafloc",
+      1,
+      []()
+      {
+        auto res = make_poafloc();
+        do_not_optimize(res);
+      }
+  );
+
+  // a typical invocation, a long mixed one and a long list of files
+  static std::array<std::pair<std::string, corpus>, 3> corpora = {{
+      {"small", corpus({"bench", "-ab", "--name=value", "-i", "42", "a.c"})},
+      {"mixed",
+       corpus(with_files(
+           repeat(
+               {"-abc",
+                "--name",
+                "value",
+                "-i42",
+                "--output=out.txt",
+                "--verb=2",
+                "--variable",
+                "x"},
+               16
+           ),
+           1
+       ))},
+      {"files",
+       corpus(with_files({"bench", "-a", "--output=out.txt"}, 1000))},
+  }};
+
+  const auto run_poafloc = [](options& rec, corpus& args)
+  {
+    program(rec, args.argc(), args.argv());
+    return true;
+  };
+  const auto run_getopt = [](options& rec, corpus& args)
+  { return parse_getopt(rec, args.argc(), args.argv()); };
+  const auto run_argp = [](options& rec, corpus& args)
+  { return parse_argp(rec, args.argc(), args.argv()); };
+
+  for (auto& [name, args] : corpora) {
+    // measuring different work would prove nothing
+    options expected;
+    options from_getopt;
+    options from_argp;
+    run_poafloc(expected, args);
+    if (!run_getopt(from_getopt, args) || !run_argp(from_argp, args)
+        || from_getopt != expected || from_argp != expected)
+    {
+      throw std::runtime_error("compare: parsers disagree on " + name);
+    }
+
+    const auto prefix = "compare/" + name;
+    add_compare(
+        benchmarks, prefix + "/poafloc", args, run_poafloc, heap::counted
+    );
+    add_compare(
+        benchmarks, prefix + "/getopt_long", args, run_getopt, heap::unseen
+    );
+    add_compare(benchmarks, prefix + "/argp", args, run_argp, heap::unseen);
+  }
+}
+
+}  // namespace poafloc::bench
@@ -0,0 +1,120 @@
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <poafloc/config.hpp>
+#include <poafloc/poafloc.hpp>
+
+#include "bench.hpp"
+
+namespace
+{
+
+struct record
+{
+  // NOLINTBEGIN(*non-private*)
+  int number = 0;
+  std::size_t count = 0;
+  // NOLINTEND(*non-private*)
+
+  void set(std::string_view value) { count += std::size(value); }
+};
+
+auto make_parser()
+{
+  using poafloc::direct;
+  using poafloc::group;
+  using poafloc::list;
+
+  return poafloc::parser<record> {
+      group {
+          "server",
+          direct {"n name", &record::set, "NAME Name"},
+          direct {"i integer", &record::number, "NUM Integer"},
+          direct {"address", &record::set, "ADDR Address"},
+      },
+      group {
+          "routes",
+          list {"route", &record::set, "ROUTE Route"},
+      },
+  };
+}
+
+constexpr std::size_t keys = 20'000;
+
+// a service config, most of it one long section
+std::filesystem::path write_file()
+{
+  const auto path =
+      std::filesystem::temp_directory_path() / "poafloc-bench-config.ini";
+
+  std::ofstream ofs(path, std::ios::binary);
+  ofs << "# generated\n[server]\nname = bench\ninteger = 42\n";
+  ofs << "address = \"127.0.0.1:8080\"\n\n[routes]\n";
+  for (std::size_t i = 3; i < keys; i++) {
+    ofs << "route = /api/v1/resource_" << i << "\n";
+  }
+  return path;
+}
+
+// reading line by line into strings, the way it is done by hand
+void read_config(const std::filesystem::path& path, record& rec)
+{
+  std::ifstream ifs(path, std::ios::binary);
+  std::string line;
+  while (std::getline(ifs, line)) {
+    if (line.empty() || line.front() == '#' || line.front() == '[') {
+      continue;
+    }
+
+    const auto equal = line.find('=');
+    std::string key = line.substr(0, equal);
+    std::string value = line.substr(equal + 1);
+    key.erase(key.find_last_not_of(' ') + 1);
+    value.erase(0, value.find_first_not_of(' '));
+
+    if (key == "integer") {
+      rec.number = std::stoi(value);
+    } else {
+      rec.set(value);
+    }
+  }
+}
+
+}  // namespace
+
+namespace poafloc::bench
+{
+
+void register_config(suite& benchmarks)
+{
+  static const auto program = make_parser();
+  static const auto path = write_file();
+
+  benchmarks.add(
+      "config/load",
+      keys,
+      []()
+      {
+        const poafloc::config_file file(path);
+        record rec;
+        program.load(rec, file.text());
+        do_not_optimize(rec);
+      }
+  );
+  benchmarks.add(
+      "config/getline",
+      keys,
+      []()
+      {
+        record rec;
+        read_config(path, rec);
+        do_not_optimize(rec);
+      }
+  );
+}
+
+}  // namespace poafloc::bench
@@ -0,0 +1,141 @@
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <poafloc/convert.hpp>
+#include <poafloc/poafloc.hpp>
+
+#include "bench.hpp"
+
+namespace
+{
+
+// a parameter sweep, as a simulation launcher passes it
+struct sweep
+{
+  // NOLINTBEGIN(*non-private*)
+  bool dry_run = false;
+  std::vector<int> seeds;
+  std::vector<double> rates;
+  // NOLINTEND(*non-private*)
+};
+
+auto make_parser()
+{
+  using poafloc::boolean;
+  using poafloc::group;
+  using poafloc::list;
+
+  return poafloc::parser<sweep> {
+      group {
+          "sweep",
+          boolean {"n dry", &sweep::dry_run, "Only print the jobs"},
+          list {"s seeds", &sweep::seeds, "SEED Random seeds"},
+          list {"r rates", &sweep::rates, "RATE Learning rates"},
+      },
+  };
+}
+
+std::vector<std::string> make_ints(std::size_t count)
+{
+  std::vector<std::string> res;
+  res.reserve(count);
+  for (std::size_t i = 0; i < count; i++) {
+    // NOLINTNEXTLINE(*magic*)
+    res.push_back(std::to_string(static_cast<int>(i * 2654435761U % 1000003)));
+  }
+  return res;
+}
+
+// identifiers and timestamps, long enough to be read a word at a time
+std::vector<std::string> make_longs(std::size_t count)
+{
+  std::vector<std::string> res;
+  res.reserve(count);
+  for (std::size_t i = 0; i < count; i++) {
+    // NOLINTNEXTLINE(*magic*)
+    res.push_back(std::to_string(1'700'000'000'000'000 + (i * 2654435761U)));
+  }
+  return res;
+}
+
+std::vector<std::string> make_doubles(std::size_t count)
+{
+  std::vector<std::string> res;
+  res.reserve(count);
+  for (std::size_t i = 0; i < count; i++) {
+    res.push_back("0." + std::to_string(i * 7919 % 100000));  // NOLINT
+  }
+  return res;
+}
+
+std::vector<std::string> with_option(
+    std::string_view opt, const std::vector<std::string>& values
+)
+{
+  std::vector<std::string> res = {"bench", std::string(opt)};
+  res.insert(res.end(), values.begin(), values.end());
+  return res;
+}
+
+template<class T>
+void add_convert(
+    poafloc::bench::suite& benchmarks,
+    std::string name,
+    const std::vector<std::string>& values
+)
+{
+  benchmarks.add(
+      std::move(name),
+      std::size(values),
+      [&values]()
+      {
+        for (const auto& value : values) {
+          T res = {};
+          poafloc::bench::do_not_optimize(poafloc::convert(value, res));
+          poafloc::bench::do_not_optimize(res);
+        }
+      }
+  );
+}
+
+}  // namespace
+
+namespace poafloc::bench
+{
+
+void register_convert(suite& benchmarks)
+{
+  static const auto ints = make_ints(100'000);
+  static const auto doubles = make_doubles(100'000);
+
+  static const auto longs = make_longs(100'000);
+
+  add_convert<int>(benchmarks, "convert/int", ints);
+  add_convert<std::int64_t>(benchmarks, "convert/long", longs);
+  add_convert<double>(benchmarks, "convert/double", doubles);
+
+  static const auto program = make_parser();
+  static const auto seeds = with_option("--seeds", ints);
+  static const auto rates = with_option("--rates", doubles);
+
+  const auto add_sweep = [&](std::string name, const auto& args)
+  {
+    benchmarks.add(
+        std::move(name),
+        std::size(args) - 2,
+        [&args]()
+        {
+          sweep rec;
+          program(rec, args);
+          do_not_optimize(rec);
+        }
+    );
+  };
+  add_sweep("convert/sweep/int", seeds);
+  add_sweep("convert/sweep/double", rates);
+}
+
+}  // namespace poafloc::bench
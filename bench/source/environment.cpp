@@ -0,0 +1,137 @@
+#include <cstddef>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <poafloc/poafloc.hpp>
+
+#include "bench.hpp"
+
+namespace
+{
+
+struct record
+{
+  // NOLINTBEGIN(*non-private*)
+  std::size_t count = 0;
+  // NOLINTEND(*non-private*)
+
+  void set(std::string_view value) { count += std::size(value); }
+};
+
+constexpr std::size_t options = 16;
+constexpr std::size_t variables = 2000;
+
+// long names "option0" to "option15", read from APP_OPTION0 and so on
+std::vector<std::string> make_names()
+{
+  std::vector<std::string> res;
+  for (std::size_t i = 0; i < options; i++) {
+    res.push_back("option" + std::to_string(i));
+  }
+  return res;
+}
+
+const std::vector<std::string>& names()
+{
+  static const auto res = make_names();
+  return res;
+}
+
+auto make_parser(std::string_view prefix)
+{
+  using poafloc::direct;
+  using poafloc::group;
+
+  const auto& opts = names();
+  auto res = poafloc::parser<record> {
+      group {
+          "unnamed",
+          direct {opts[0], &record::set, "VALUE Value"},
+          direct {opts[1], &record::set, "VALUE Value"},
+          direct {opts[2], &record::set, "VALUE Value"},
+          direct {opts[3], &record::set, "VALUE Value"},
+          direct {opts[4], &record::set, "VALUE Value"},
+          direct {opts[5], &record::set, "VALUE Value"},
+          direct {opts[6], &record::set, "VALUE Value"},
+          direct {opts[7], &record::set, "VALUE Value"},
+          direct {opts[8], &record::set, "VALUE Value"},
+          direct {opts[9], &record::set, "VALUE Value"},
+          direct {opts[10], &record::set, "VALUE Value"},
+          direct {opts[11], &record::set, "VALUE Value"},
+          direct {opts[12], &record::set, "VALUE Value"},
+          direct {opts[13], &record::set, "VALUE Value"},
+          direct {opts[14], &record::set, "VALUE Value"},
+          direct {opts[15], &record::set, "VALUE Value"},
+      },
+  };
+  res.env_prefix(prefix);
+  return res;
+}
+
+// a container sized environment, with half of the options set in it
+void fill_environment()
+{
+  for (std::size_t i = 0; i < variables; i++) {
+    const auto name = "UNRELATED_VARIABLE_" + std::to_string(i);
+    ::setenv(name.c_str(), "some value", 1);  // NOLINT(*mt-unsafe*)
+  }
+  for (std::size_t i = 0; i < options; i += 2) {
+    const auto name = "APP_OPTION" + std::to_string(i);
+    ::setenv(name.c_str(), "value", 1);  // NOLINT(*mt-unsafe*)
+  }
+}
+
+}  // namespace
+
+namespace poafloc::bench
+{
+
+void register_environment(suite& benchmarks)
+{
+  fill_environment();
+
+  static const auto program = make_parser("APP_");
+  static const auto plain = make_parser("");
+  static const std::vector<std::string_view> args = {"bench"};
+
+  benchmarks.add(
+      "environment/index",
+      options,
+      []()
+      {
+        record rec;
+        program(rec, args);
+        do_not_optimize(rec);
+      }
+  );
+
+  // the way it is done by hand, one getenv per option
+  static const auto env_names = []
+  {
+    std::vector<std::string> res;
+    for (std::size_t i = 0; i < options; i++) {
+      res.push_back("APP_OPTION" + std::to_string(i));
+    }
+    return res;
+  }();
+  benchmarks.add(
+      "environment/getenv",
+      options,
+      []()
+      {
+        record rec;
+        plain(rec, args);
+        for (const auto& name : env_names) {
+          const char* value = std::getenv(name.c_str());  // NOLINT(*mt-unsafe*)
+          if (value != nullptr) {
+            rec.set(value);
+          }
+        }
+        do_not_optimize(rec);
+      }
+  );
+}
+
+}  // namespace poafloc::bench
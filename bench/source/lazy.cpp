@@ -0,0 +1,124 @@
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <poafloc/lazy.hpp>
+#include <poafloc/poafloc.hpp>
+
+#include "bench.hpp"
+
+namespace
+{
+
+// comma separated numbers, the kind of value worth deferring
+struct numbers
+{
+  std::vector<int> values;  // NOLINT(*non-private*)
+};
+
+bool from_string(std::string_view value, numbers& out)
+{
+  while (!value.empty()) {
+    const auto end = value.find(',');
+    int num = 0;
+    if (poafloc::convert(value.substr(0, end), num) != std::errc {}) {
+      return false;
+    }
+    out.values.push_back(num);
+    value.remove_prefix(
+        end == std::string_view::npos ? std::size(value) : end + 1
+    );
+  }
+  return true;
+}
+
+template<class Field>
+struct record
+{
+  // NOLINTBEGIN(*non-private*)
+  bool flag = false;
+  Field include;
+  Field exclude;
+  // NOLINTEND(*non-private*)
+};
+
+template<class Field>
+auto make_parser()
+{
+  using poafloc::boolean;
+  using poafloc::direct;
+  using poafloc::group;
+
+  using rec = record<Field>;
+  return poafloc::parser<rec> {
+      group {
+          "unnamed",
+          boolean {"f flag", &rec::flag, "Flag"},
+          direct {"include", &rec::include, "IDS Included"},
+          direct {"exclude", &rec::exclude, "IDS Excluded"},
+      },
+  };
+}
+
+std::string make_ids(std::size_t count)
+{
+  std::string res;
+  for (std::size_t i = 0; i < count; i++) {
+    res += std::to_string(i * 7919);  // NOLINT(*magic*)
+    res += ',';
+  }
+  res.pop_back();
+  return res;
+}
+
+}  // namespace
+
+namespace poafloc::bench
+{
+
+void register_lazy(suite& benchmarks)
+{
+  static const auto eager = make_parser<numbers>();
+  static const auto deferred = make_parser<poafloc::lazy<numbers>>();
+
+  // a wrapper that parses the whole command line, but reads only the flag
+  static const std::string ids = "--include=" + make_ids(500);
+  static const std::vector<std::string_view> args = {
+      "bench", "-f", ids, "--exclude=1,2,3"
+  };
+
+  benchmarks.add(
+      "lazy/eager",
+      std::size(args) - 1,
+      []()
+      {
+        record<numbers> rec;
+        eager(rec, args);
+        do_not_optimize(rec);
+      }
+  );
+  benchmarks.add(
+      "lazy/deferred",
+      std::size(args) - 1,
+      []()
+      {
+        record<poafloc::lazy<numbers>> rec;
+        deferred(rec, args);
+        do_not_optimize(rec);
+      }
+  );
+  benchmarks.add(
+      "lazy/deferred_read",
+      std::size(args) - 1,
+      []()
+      {
+        record<poafloc::lazy<numbers>> rec;
+        deferred(rec, args);
+        do_not_optimize(rec.include.get());
+        do_not_optimize(rec);
+      }
+  );
+}
+
+}  // namespace poafloc::bench
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string_view>
+
+namespace poafloc::bench
+{
+
+// Pointer based trie used for long options before the switch to a node pool,
+// kept as a baseline for the trie benchmarks
+class legacy_trie
+{
+  using value_type = std::uint64_t;
+  using opt_type = std::optional<value_type>;
+
+  static constexpr std::size_t size = 26 + 10;
+  static constexpr value_type sentinel = ~value_type {0};
+
+  std::array<std::unique_ptr<legacy_trie>, size> m_children = {};
+
+  value_type m_value = sentinel;
+  std::uint8_t m_count = 0;
+
+  bool m_terminal = false;
+  legacy_trie* m_parent = nullptr;
+
+  static constexpr std::size_t map(char chr)
+  {
+    return chr >= 'a' ? static_cast<std::size_t>(chr - 'a' + 10)
+                      : static_cast<std::size_t>(chr - '0');
+  }
+
+public:
+  explicit legacy_trie(legacy_trie* parent = nullptr)
+      : m_parent(parent)
+  {
+  }
+
+  static bool set(legacy_trie& trie, std::string_view key, value_type value)
+  {
+    legacy_trie* crnt = &trie;
+    for (const auto c : key) {
+      crnt->m_count++;
+      if (!crnt->m_terminal) {
+        crnt->m_value = value;
+      }
+
+      const auto idx = map(c);
+      if (crnt->m_children[idx] == nullptr) {
+        crnt->m_children[idx] = std::make_unique<legacy_trie>(nullptr);
+      }
+      crnt = crnt->m_children[idx].get();
+    }
+
+    if (crnt->m_terminal) {
+      return false;
+    }
+
+    crnt->m_value = value;
+    crnt->m_terminal = true;
+    return true;
+  }
+
+  // out of line, just like the library's lookups
+  [[gnu::noinline]] static opt_type get(
+      const legacy_trie& trie, std::string_view key
+  )
+  {
+    const legacy_trie* crnt = &trie;
+
+    for (const auto c : key) {
+      const auto idx = map(c);
+      if (crnt->m_children[idx] == nullptr) {
+        return {};
+      }
+      crnt = crnt->m_children[idx].get();
+    }
+
+    if (crnt->m_terminal || crnt->m_count == 1) {
+      return crnt->m_value;
+    }
+
+    return {};
+  }
+};
+
+}  // namespace poafloc::bench
@@ -0,0 +1,80 @@
+#include <charconv>
+#include <chrono>
+#include <iostream>
+#include <string_view>
+
+#include "bench.hpp"
+
+namespace
+{
+
+void usage(std::string_view program)
+{
+  std::cerr << "Usage: " << program
+            << " [--format=text|json|csv] [--filter=SUBSTR] [--min-time=MS]\n";
+}
+
+}  // namespace
+
+// The benchmark driver deliberately doesn't use poafloc itself, so a broken
+// parser can't skew or hide its own measurements
+int main(int argc, const char** argv)
+{
+  using namespace poafloc::bench;  // NOLINT
+
+  const auto program = std::string_view(argv[0]);  // NOLINT(*pointer*)
+  std::string_view format = "text";
+  std::string_view filter;
+  auto min_time = std::chrono::milliseconds(100);
+
+  for (int i = 1; i < argc; i++) {
+    const auto arg = std::string_view(argv[i]);  // NOLINT(*pointer*)
+    const auto value = arg.substr(arg.find('=') + 1);
+
+    if (arg.starts_with("--format=")) {
+      format = value;
+    } else if (arg.starts_with("--filter=")) {
+      filter = value;
+    } else if (arg.starts_with("--min-time=")) {
+      long long msec = 0;
+      const auto* end = value.data() + value.size();  // NOLINT(*pointer*)
+      if (std::from_chars(value.data(), end, msec).ptr != end) {
+        usage(program);
+        return 1;
+      }
+      min_time = std::chrono::milliseconds(msec);
+    } else {
+      usage(program);
+      return arg == "--help" ? 0 : 1;
+    }
+  }
+
+  suite benchmarks;
+  register_command(benchmarks);
+#if defined(POAFLOC_BENCH_COMPARE)
+  register_compare(benchmarks);
+#endif
+  register_config(benchmarks);
+  register_convert(benchmarks);
+  register_environment(benchmarks);
+  register_lazy(benchmarks);
+  register_option(benchmarks);
+  register_parser(benchmarks);
+  register_response(benchmarks);
+  register_tokenizer(benchmarks);
+  register_trie(benchmarks);
+
+  const auto results = benchmarks.run(filter, min_time);
+  if (format == "json") {
+    report_json(std::cout, results);
+  } else if (format == "csv") {
+    report_csv(std::cout, results);
+  } else if (format == "text") {
+    report_text(std::cout, results);
+  } else {
+    usage(program);
+    return 1;
+  }
+
+  return 0;
+}
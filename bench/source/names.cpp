@@ -0,0 +1,42 @@
+#include <cstdint>
+#include <unordered_set>
+
+#include "names.hpp"
+
+namespace poafloc::bench
+{
+
+std::vector<std::string> make_names(std::size_t count)
+{
+  static constexpr std::uint64_t multiplier = 6364136223846793005U;
+  static constexpr std::uint64_t increment = 1442695040888963407U;
+  static constexpr std::size_t min_length = 4;
+  static constexpr std::size_t max_length = 16;
+
+  std::uint64_t state = count;
+  const auto next = [&state](std::uint64_t bound)
+  {
+    state = (state * multiplier) + increment;
+    return (state >> 33U) % bound;  // NOLINT(*magic*)
+  };
+
+  std::vector<std::string> res;
+  std::unordered_set<std::string> seen;
+  while (std::size(res) < count) {
+    std::string name;
+    const auto length = min_length + next(max_length - min_length + 1);
+    for (std::size_t i = 0; i < length; i++) {
+      // mostly letters, with some common words sharing prefixes
+      static constexpr std::uint64_t letters = 26;
+      name += static_cast<char>('a' + next(letters));
+    }
+
+    if (seen.insert(name).second) {
+      res.push_back(std::move(name));
+    }
+  }
+
+  return res;
+}
+
+}  // namespace poafloc::bench
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace poafloc::bench
+{
+
+// Deterministic set of unique, valid long option names
+std::vector<std::string> make_names(std::size_t count);
+
+}  // namespace poafloc::bench
@@ -0,0 +1,90 @@
+#include <array>
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+#include <poafloc/poafloc.hpp>
+
+#include "bench.hpp"
+
+namespace
+{
+
+struct record
+{
+  // NOLINTBEGIN(*non-private*)
+  bool flag = false;
+  int number = 0;
+  std::size_t count = 0;
+  // NOLINTEND(*non-private*)
+
+  void set(std::string_view value) { count += std::size(value); }
+};
+
+constexpr std::size_t tokens = 1024;
+
+// calls the setter of a single option once per token, nothing else
+template<class Option>
+void add(
+    poafloc::bench::suite& benchmarks,
+    std::string name,
+    Option opt,
+    std::string_view value
+)
+{
+  benchmarks.add(
+      std::move(name),
+      tokens,
+      [opt = std::move(opt), value]()
+      {
+        record rec;
+        for (std::size_t i = 0; i < tokens; i++) {
+          const auto err = opt(&rec, value);
+          poafloc::bench::do_not_optimize(err);
+        }
+        poafloc::bench::do_not_optimize(rec);
+      }
+  );
+}
+
+}  // namespace
+
+namespace poafloc::bench
+{
+
+void register_option(suite& benchmarks)
+{
+  using poafloc::boolean;
+  using poafloc::direct;
+
+  add(benchmarks,
+      "option/dispatch/boolean",
+      boolean {"f flag", &record::flag, "Flag"},
+      "program");
+  add(benchmarks,
+      "option/dispatch/setter",
+      direct {"n name", &record::set, "NAME Name"},
+      "value");
+  add(benchmarks,
+      "option/dispatch/convert",
+      direct {"i integer", &record::number, "NUM Integer"},
+      "12345");
+
+  // copies of the options, as done while a parser is constructed
+  static const std::vector<poafloc::detail::option> options = {
+      boolean {"f flag", &record::flag, "Flag"},
+      direct {"n name", &record::set, "NAME Name"},
+      direct {"i integer", &record::number, "NUM Integer"},
+  };
+  benchmarks.add(
+      "option/copy",
+      std::size(options),
+      []()
+      {
+        auto copy = options;
+        do_not_optimize(copy);
+      }
+  );
+}
+
+}  // namespace poafloc::bench
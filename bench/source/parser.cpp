@@ -0,0 +1,428 @@
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <poafloc/poafloc.hpp>
+
+#include "bench.hpp"
+
+namespace
+{
+
+struct record
+{
+  // NOLINTBEGIN(*non-private*)
+  bool flag_a = false;
+  bool flag_b = false;
+  bool flag_c = false;
+  int number = 0;
+  std::size_t count = 0;
+  // NOLINTEND(*non-private*)
+
+  // cheapest possible setter, so only the parser itself is measured
+  void set(std::string_view value) { count += std::size(value); }
+};
+
+using poafloc::argument_list;
+using poafloc::argv_view;
+using poafloc::boolean;
+using poafloc::direct;
+using poafloc::group;
+using poafloc::list;
+using poafloc::parse_session;
+using poafloc::parser;
+using poafloc::positional;
+
+auto make_options()
+{
+  return parser<record> {
+      group {
+          "flags",
+          boolean {"a all", &record::flag_a, "Flag a"},
+          boolean {"b brief", &record::flag_b, "Flag b"},
+          boolean {"c color", &record::flag_c, "Flag c"},
+      },
+      group {
+          "values",
+          direct {"n name", &record::set, "NAME Name"},
+          direct {"i integer", &record::number, "NUM Integer"},
+          direct {"verbose", &record::set, "LEVEL Verbosity"},
+          direct {"version", &record::set, "VER Version"},
+          direct {"variable", &record::set, "VAR Variable"},
+          direct {"output", &record::set, "FILE Output"},
+          direct {"outputfile", &record::set, "FILE Output file"},
+          list {"l list", &record::set, "VALUE List of values"},
+      },
+  };
+}
+
+auto make_positional()
+{
+  return parser<record> {
+      positional {
+          argument_list {"rest", &record::set},
+      },
+      group {
+          "flags",
+          boolean {"a all", &record::flag_a, "Flag a"},
+      },
+  };
+}
+
+// the files of a build job, pushed back by a setter or appended to the
+// member directly, with room made for all of them first
+struct files_record
+{
+  // NOLINTBEGIN(*non-private*)
+  bool flag_a = false;
+  std::vector<std::string> files;
+  // NOLINTEND(*non-private*)
+
+  void add(std::string_view value) { files.emplace_back(value); }
+};
+
+template<class Member>
+auto make_files(Member member)
+{
+  return parser<files_record> {
+      positional {
+          argument_list {"files", member},
+      },
+      group {
+          "flags",
+          boolean {"a all", &files_record::flag_a, "Flag a"},
+          list {"f file", member, "FILE Files"},
+      },
+  };
+}
+
+using args_type = std::vector<std::string_view>;
+
+args_type repeat(std::initializer_list<std::string_view> args, std::size_t cnt)
+{
+  args_type res = {"bench"};
+  res.reserve(1 + (std::size(args) * cnt));
+  for (std::size_t i = 0; i < cnt; i++) {
+    res.insert(res.end(), args);
+  }
+  return res;
+}
+
+args_type with_values(args_type head, std::size_t cnt)
+{
+  head.reserve(std::size(head) + cnt);
+  for (std::size_t i = 0; i < cnt; i++) {
+    head.emplace_back("value");
+  }
+  return head;
+}
+
+template<class Parser>
+void add(
+    poafloc::bench::suite& benchmarks,
+    std::string name,
+    Parser& program,
+    args_type args
+)
+{
+  const auto items = std::size(args) - 1;
+  benchmarks.add(
+      std::move(name),
+      items,
+      [&program, args = std::move(args)]()
+      {
+        record rec;
+        program(rec, args);
+        poafloc::bench::do_not_optimize(rec);
+      }
+  );
+}
+
+// same as add, but through the argc/argv entry point
+template<class Parser>
+void add_argv(
+    poafloc::bench::suite& benchmarks,
+    std::string name,
+    Parser& program,
+    const args_type& args
+)
+{
+  std::vector<std::string> storage(std::begin(args), std::end(args));
+  std::vector<const char*> argv;
+  argv.reserve(std::size(storage));
+  for (const auto& arg : storage) {
+    argv.push_back(arg.c_str());
+  }
+
+  const auto items = std::size(args) - 1;
+  benchmarks.add(
+      std::move(name),
+      items,
+      [&program,
+       storage = std::make_shared<std::vector<std::string>>(std::move(storage)),
+       argv = std::move(argv)]() mutable
+      {
+        record rec;
+        program(rec, static_cast<int>(std::size(argv)), argv.data());
+        poafloc::bench::do_not_optimize(rec);
+      }
+  );
+}
+
+// same as add, but straight from the strings that own the arguments
+template<class Parser>
+void add_strings(
+    poafloc::bench::suite& benchmarks,
+    std::string name,
+    Parser& program,
+    const args_type& args
+)
+{
+  const auto items = std::size(args) - 1;
+  benchmarks.add(
+      std::move(name),
+      items,
+      [&program, strings = std::vector<std::string>(args.begin(), args.end())]()
+      {
+        record rec;
+        program(rec, strings);
+        poafloc::bench::do_not_optimize(rec);
+      }
+  );
+}
+
+}  // namespace
+
+namespace poafloc::bench
+{
+
+void register_parser(suite& benchmarks)
+{
+  static auto options = make_options();
+  static auto positional = make_positional();
+
+  benchmarks.add(
+      "parser/construct",
+      1,
+      []()
+      {
+        auto program = make_options();
+        do_not_optimize(program);
+      }
+  );
+
+  add(benchmarks, "parser/short_cluster", options, repeat({"-abc"}, 32));
+  add(benchmarks, "parser/short_value", options, repeat({"-n", "value"}, 16));
+  add(benchmarks, "parser/short_together", options, repeat({"-nvalue"}, 32));
+  add(benchmarks,
+      "parser/long_value",
+      options,
+      repeat({"--name", "value"}, 16));
+  add(benchmarks, "parser/long_equal", options, repeat({"--name=value"}, 32));
+  add(benchmarks,
+      "parser/long_abbrev",
+      options,
+      repeat({"--verb=value", "--vari=value", "--outputf=value"}, 16));
+  add(benchmarks,
+      "parser/long_abbrev_value",
+      options,
+      repeat({"--verb", "value", "--vari", "value"}, 16));
+  add(benchmarks,
+      "parser/convert_int",
+      options,
+      repeat({"-i", "12345", "--integer=-42"}, 16));
+  add(benchmarks, "parser/list", options, with_values({"bench", "-l"}, 256));
+  add(benchmarks,
+      "parser/argument_list",
+      positional,
+      with_values({"bench"}, 256));
+  add(benchmarks,
+      "parser/positional_tail",
+      positional,
+      with_values({"bench", "-a", "--"}, 4096));
+
+  // rejecting a malformed command line, the conversion fails
+  static const args_type rejected = {"bench", "-a", "--integer=12x"};
+  benchmarks.add(
+      "parser/reject/throw",
+      std::size(rejected) - 1,
+      []()
+      {
+        record rec;
+        try {
+          options(rec, rejected);
+        } catch (const poafloc::runtime_error& err) {
+          do_not_optimize(err);
+        }
+        do_not_optimize(rec);
+      }
+  );
+  benchmarks.add(
+      "parser/reject/try",
+      std::size(rejected) - 1,
+      []()
+      {
+        record rec;
+        const auto res = options.try_parse(rec, rejected);
+        do_not_optimize(res);
+        do_not_optimize(rec);
+      }
+  );
+
+  // the same mixed command line, unobserved and with an observer that does
+  // the least it can
+  static const auto mixed =
+      repeat({"--verb", "value", "-abc", "-nvalue", "--name=value"}, 16);
+  add(benchmarks, "parser/observed/none", options, mixed);
+  benchmarks.add(
+      "parser/observed/count",
+      std::size(mixed) - 1,
+      []()
+      {
+        struct counter
+        {
+          std::size_t events = 0;
+          void on_event(const poafloc::parse_event& /*event*/) { events++; }
+        };
+
+        record rec;
+        counter obs;
+        const auto res = options.try_parse(rec, mixed, obs);
+        do_not_optimize(res);
+        do_not_optimize(obs);
+        do_not_optimize(rec);
+      }
+  );
+
+  // NUL separated arguments, as read from a pipe: pushed into a session
+  // as they are split off, or collected first and parsed at the end
+  static const std::string stream = []
+  {
+    std::string res;
+    for (const auto arg : with_values({"bench", "-a", "--"}, 4096)) {
+      res += arg;
+      res += '\0';
+    }
+    return res;
+  }();
+  static const auto split = [](auto&& take)
+  {
+    std::string_view rest = stream;
+    while (!rest.empty()) {
+      const auto end = rest.find('\0');
+      take(rest.substr(0, end));
+      rest.remove_prefix(end + 1);
+    }
+  };
+  benchmarks.add(
+      "parser/stream/session",
+      4098,
+      []()
+      {
+        record rec;
+        parse_session session(positional, rec);
+        split([&](std::string_view arg) { (void)session.feed(arg); });
+        const auto res = session.finish();
+        do_not_optimize(res);
+        do_not_optimize(rec);
+      }
+  );
+  benchmarks.add(
+      "parser/stream/buffered",
+      4098,
+      []()
+      {
+        record rec;
+        std::vector<std::string> args;
+        split([&](std::string_view arg) { args.emplace_back(arg); });
+        const auto res = positional.try_parse(rec, args);
+        do_not_optimize(res);
+        do_not_optimize(rec);
+      }
+  );
+
+  static const auto pushed = make_files(&files_record::add);
+  static const auto reserved = make_files(&files_record::files);
+  static const auto paths = []
+  {
+    std::vector<std::string> res = {"bench", "--"};
+    for (std::size_t i = 0; i < 100'000; i++) {
+      res.push_back("build/objects/source_" + std::to_string(i) + ".o");
+    }
+    return res;
+  }();
+  // the same files, each one given as -f FILE
+  static const auto runs = []
+  {
+    std::vector<std::string> res = {"bench"};
+    for (std::size_t i = 2; i < std::size(paths); i++) {
+      res.emplace_back("-f");
+      res.push_back(paths[i]);
+    }
+    res.emplace_back("--");
+    res.emplace_back("last.o");
+    return res;
+  }();
+  const auto add_files = [&](std::string name,
+                             const auto& program,
+                             const std::vector<std::string>& args)
+  {
+    benchmarks.add(
+        std::move(name),
+        std::size(paths) - 2,
+        [&program, &args]()
+        {
+          files_record rec;
+          program(rec, args);
+          do_not_optimize(rec);
+        }
+    );
+  };
+  add_files("parser/container/push_back", pushed, paths);
+  add_files("parser/container/reserved", reserved, paths);
+  add_files("parser/container/runs/push_back", pushed, runs);
+  add_files("parser/container/runs/reserved", reserved, runs);
+
+  add_argv(benchmarks,
+           "parser/argv_tail",
+           positional,
+           with_values({"bench", "-a", "--"}, 100'000));
+
+  // typical command line, parsed once per process
+  static const args_type small = {"bench", "-ab", "--name=value", "-i", "42"};
+  add_argv(benchmarks, "parser/argv_small", options, small);
+  add_strings(benchmarks, "parser/strings_small", options, small);
+
+  // many small command lines, one after the other and on the thread pool
+  static const std::vector<const char*> line = {
+      "bench", "-ab", "--name=value", "-i", "42"
+  };
+  static const std::vector<argv_view> lines(4096, argv_view(line));
+  benchmarks.add(
+      "parser/batch/serial",
+      std::size(lines),
+      []()
+      {
+        std::vector<record> records(std::size(lines));
+        for (std::size_t i = 0; i < std::size(lines); i++) {
+          const auto res = options.try_parse(records[i], lines[i]);
+          do_not_optimize(res);
+        }
+        do_not_optimize(records);
+      }
+  );
+  benchmarks.add(
+      "parser/batch/pool",
+      std::size(lines),
+      []()
+      {
+        std::vector<record> records(std::size(lines));
+        const auto res = options.parse_batch(lines, records);
+        do_not_optimize(res);
+        do_not_optimize(records);
+      }
+  );
+}
+
+}  // namespace poafloc::bench
@@ -0,0 +1,156 @@
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <poafloc/poafloc.hpp>
+#include <poafloc/response.hpp>
+
+#include "bench.hpp"
+
+namespace
+{
+
+struct record
+{
+  // NOLINTBEGIN(*non-private*)
+  bool flag = false;
+  std::size_t count = 0;
+  // NOLINTEND(*non-private*)
+
+  void set(std::string_view value) { count += std::size(value); }
+};
+
+auto make_parser()
+{
+  using poafloc::argument_list;
+  using poafloc::boolean;
+  using poafloc::group;
+  using poafloc::positional;
+
+  return poafloc::parser<record> {
+      positional {
+          argument_list {"objects", &record::set},
+      },
+      group {
+          "unnamed",
+          boolean {"f flag", &record::flag, "Flag"},
+      },
+  };
+}
+
+constexpr std::size_t entries = 500'000;
+
+// linker style argument list, one object file per line
+std::string write_file()
+{
+  const auto path =
+      std::filesystem::temp_directory_path() / "poafloc-bench-response";
+
+  std::ofstream ofs(path, std::ios::binary);
+  for (std::size_t i = 0; i < entries; i++) {
+    ofs << "build/objects/source_" << i << ".o\n";
+  }
+  return "@" + path.string();
+}
+
+constexpr std::size_t parts = 1000;
+constexpr std::size_t part_entries = 10;
+
+// a long list with short response files spread through it, so each nested
+// file is expanded in front of most of the list
+std::string write_nested()
+{
+  const auto dir = std::filesystem::temp_directory_path();
+  const auto path = dir / "poafloc-bench-response-nested";
+
+  std::ofstream ofs(path, std::ios::binary);
+  for (std::size_t i = 0; i < parts; i++) {
+    const auto part =
+        dir / ("poafloc-bench-response-part-" + std::to_string(i));
+    std::ofstream part_ofs(part, std::ios::binary);
+    for (std::size_t j = 0; j < part_entries; j++) {
+      part_ofs << "build/parts/source_" << i << "_" << j << ".o\n";
+    }
+
+    ofs << "@" << part.string() << "\n";
+    for (std::size_t j = 0; j < entries / parts; j++) {
+      ofs << "build/objects/source_" << i << "_" << j << ".o\n";
+    }
+  }
+  return "@" + path.string();
+}
+
+// reading the file into strings first, the way it is done by hand
+std::vector<std::string> read_words(std::string_view file)
+{
+  std::ifstream ifs(std::string(file.substr(1)), std::ios::binary);
+  std::vector<std::string> words = {"bench"};
+  words.insert(
+      words.end(),
+      std::istream_iterator<std::string>(ifs),
+      std::istream_iterator<std::string>()
+  );
+  return words;
+}
+
+}  // namespace
+
+namespace poafloc::bench
+{
+
+void register_response(suite& benchmarks)
+{
+  static const auto program = make_parser();
+  static const auto file = write_file();
+
+  benchmarks.add(
+      "response/expand",
+      entries,
+      []()
+      {
+        poafloc::response_files files;
+        const std::vector<std::string_view> args = {"bench", file};
+        do_not_optimize(files.expand(args));
+      }
+  );
+  static const auto nested = write_nested();
+  benchmarks.add(
+      "response/nested",
+      entries + (parts * part_entries),
+      []()
+      {
+        poafloc::response_files files;
+        const std::vector<std::string_view> args = {"bench", nested};
+        do_not_optimize(files.expand(args));
+      }
+  );
+  benchmarks.add(
+      "response/parse",
+      entries,
+      []()
+      {
+        poafloc::response_files files;
+        const std::vector<std::string_view> args = {"bench", file};
+        record rec;
+        program(rec, files.expand(args));
+        do_not_optimize(rec);
+      }
+  );
+  benchmarks.add(
+      "response/read_parse",
+      entries,
+      []()
+      {
+        const auto words = read_words(file);
+        record rec;
+        program(rec, words);
+        do_not_optimize(rec);
+      }
+  );
+}
+
+}  // namespace poafloc::bench
@@ -0,0 +1,136 @@
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <poafloc/poafloc.hpp>
+#include <poafloc/tokenizer.hpp>
+
+#include "bench.hpp"
+
+namespace
+{
+
+struct record
+{
+  // NOLINTBEGIN(*non-private*)
+  bool flag = false;
+  int number = 0;
+  std::size_t count = 0;
+  // NOLINTEND(*non-private*)
+
+  void set(std::string_view value) { count += std::size(value); }
+};
+
+auto make_parser()
+{
+  using poafloc::argument_list;
+  using poafloc::boolean;
+  using poafloc::direct;
+  using poafloc::group;
+  using poafloc::positional;
+
+  return poafloc::parser<record> {
+      positional {
+          argument_list {"rest", &record::set},
+      },
+      group {
+          "unnamed",
+          boolean {"f flag", &record::flag, "Flag"},
+          direct {"n name", &record::set, "NAME Name"},
+          direct {"i integer", &record::number, "NUM Integer"},
+      },
+  };
+}
+
+// the usual hand written split: one string per word, unquoted as it goes
+std::vector<std::string> naive_split(std::string_view line)
+{
+  std::vector<std::string> words;
+  std::string word;
+  bool in_word = false;
+  char quote = '\0';
+  for (std::size_t i = 0; i < std::size(line); i++) {
+    const auto chr = line[i];
+    if (quote != '\0') {
+      if (chr == quote) {
+        quote = '\0';
+      } else {
+        word += chr;
+      }
+    } else if (chr == '\'' || chr == '"') {
+      quote = chr;
+      in_word = true;
+    } else if (chr == '\\' && i + 1 < std::size(line)) {
+      word += line[++i];
+      in_word = true;
+    } else if (chr == ' ') {
+      if (in_word) {
+        words.push_back(std::move(word));
+        word.clear();
+        in_word = false;
+      }
+    } else {
+      word += chr;
+      in_word = true;
+    }
+  }
+  if (in_word) {
+    words.push_back(std::move(word));
+  }
+  return words;
+}
+
+const std::string line = R"(prog -f --name="some name" -i 42 --name=plain )"
+                         R"('quoted file' file\ two a b c d e f g h)";
+
+std::size_t word_count()
+{
+  poafloc::tokenizer tok;
+  return std::size(tok.split(line));
+}
+
+}  // namespace
+
+namespace poafloc::bench
+{
+
+void register_tokenizer(suite& benchmarks)
+{
+  static const auto program = make_parser();
+  static const auto words = word_count();
+
+  benchmarks.add(
+      "tokenizer/split",
+      words,
+      []()
+      {
+        static poafloc::tokenizer tok;
+        do_not_optimize(tok.split(line));
+      }
+  );
+  benchmarks.add(
+      "tokenizer/parse",
+      words,
+      []()
+      {
+        static poafloc::tokenizer tok;
+        record rec;
+        program(rec, tok.split(line));
+        do_not_optimize(rec);
+      }
+  );
+  benchmarks.add(
+      "tokenizer/naive_parse",
+      words,
+      []()
+      {
+        record rec;
+        const auto split = naive_split(line);
+        const std::vector<std::string_view> views(split.begin(), split.end());
+        program(rec, views);
+        do_not_optimize(rec);
+      }
+  );
+}
+
+}  // namespace poafloc::bench
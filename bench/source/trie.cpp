@@ -0,0 +1,188 @@
+#include <format>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include <poafloc/poafloc.hpp>
+
+#include "bench.hpp"
+#include "legacy_trie.hpp"
+#include "names.hpp"
+
+namespace
+{
+
+using poafloc::bench::legacy_trie;
+using poafloc::detail::option_index;
+using poafloc::detail::option_long;
+using poafloc::detail::perfect_hash;
+using poafloc::detail::trie_t;
+
+using names_type = std::vector<std::string>;
+using keys_type = std::vector<std::string_view>;
+
+std::size_t keys_size(const names_type& names)
+{
+  std::size_t res = 0;
+  for (const auto& name : names) {
+    res += std::size(name);
+  }
+  return res;
+}
+
+// common interface over all of the lookup structures
+template<class Trie>
+struct lookup
+{
+  static auto build(const names_type& names)
+  {
+    auto trie = std::make_shared<Trie>();
+    if constexpr (std::is_same_v<Trie, trie_t>) {
+      Trie::reserve(*trie, keys_size(names));
+    }
+
+    for (std::size_t i = 0; i < std::size(names); i++) {
+      if constexpr (std::is_same_v<Trie, trie_t>) {
+        (void)Trie::set(*trie, names[i], option_index::underlying_cast(i));
+      } else {
+        (void)Trie::set(*trie, names[i], i);
+      }
+    }
+    return trie;
+  }
+
+  static auto get(const Trie& trie, std::string_view key)
+  {
+    return Trie::get(trie, key);
+  }
+};
+
+template<>
+struct lookup<perfect_hash>
+{
+  static auto build(const names_type& names)
+  {
+    auto hash = std::make_shared<perfect_hash>();
+    hash->reserve(std::size(names), keys_size(names));
+    for (std::size_t i = 0; i < std::size(names); i++) {
+      hash->insert(names[i], option_index::underlying_cast(i));
+    }
+    hash->build();
+    return hash;
+  }
+
+  static auto get(const perfect_hash& hash, std::string_view key)
+  {
+    return hash.get(key);
+  }
+};
+
+template<>
+struct lookup<option_long>
+{
+  static auto build(const names_type& names)
+  {
+    auto opts = std::make_shared<option_long>();
+    opts->reserve(std::size(names), keys_size(names));
+    for (std::size_t i = 0; i < std::size(names); i++) {
+      (void)opts->set(names[i], option_index::underlying_cast(i));
+    }
+    opts->build();
+    return opts;
+  }
+
+  static auto get(const option_long& opts, std::string_view key)
+  {
+    return opts.get(key);
+  }
+};
+
+// shortest unique prefix of every name
+keys_type make_abbrevs(const names_type& names)
+{
+  const auto trie = lookup<legacy_trie>::build(names);
+
+  keys_type keys;
+  for (const auto& name : names) {
+    auto len = std::size_t {1};
+    while (!legacy_trie::get(*trie, name.substr(0, len)).has_value()) {
+      len++;
+    }
+    keys.emplace_back(std::string_view(name).substr(0, len));
+  }
+  return keys;
+}
+
+template<class Trie>
+void add_build(
+    poafloc::bench::suite& benchmarks,
+    std::string_view name,
+    const names_type& names
+)
+{
+  benchmarks.add(
+      std::format("{}/build/{}", name, std::size(names)),
+      std::size(names),
+      [&names]()
+      { poafloc::bench::do_not_optimize(lookup<Trie>::build(names)); }
+  );
+}
+
+template<class Trie>
+void add_get(
+    poafloc::bench::suite& benchmarks,
+    std::string_view name,
+    const names_type& names,
+    keys_type keys
+)
+{
+  const auto count = std::size(keys);
+  benchmarks.add(
+      std::format("{}/{}", name, std::size(names)),
+      count,
+      [trie = lookup<Trie>::build(names), keys = std::move(keys)]()
+      {
+        for (const auto key : keys) {
+          poafloc::bench::do_not_optimize(lookup<Trie>::get(*trie, key));
+        }
+      }
+  );
+}
+
+}  // namespace
+
+namespace poafloc::bench
+{
+
+// build reports allocated bytes per option, lookups report ns per key
+void register_trie(suite& benchmarks)
+{
+  static const std::vector<names_type> sets = {
+      make_names(10),
+      make_names(100),
+      make_names(1000),
+  };
+
+  for (const auto& names : sets) {
+    const auto exact = keys_type(std::begin(names), std::end(names));
+    const auto abbrevs = make_abbrevs(names);
+
+    add_build<legacy_trie>(benchmarks, "trie/legacy", names);
+    add_build<trie_t>(benchmarks, "trie/flat", names);
+    add_build<perfect_hash>(benchmarks, "trie/hash", names);
+
+    add_get<legacy_trie>(benchmarks, "trie/legacy/exact", names, exact);
+    add_get<trie_t>(benchmarks, "trie/flat/exact", names, exact);
+    add_get<perfect_hash>(benchmarks, "trie/hash/exact", names, exact);
+
+    add_get<legacy_trie>(benchmarks, "trie/legacy/abbrev", names, abbrevs);
+    add_get<trie_t>(benchmarks, "trie/flat/abbrev", names, abbrevs);
+
+    add_get<option_long>(benchmarks, "option_long/exact", names, exact);
+    add_get<option_long>(benchmarks, "option_long/abbrev", names, abbrevs);
+  }
+}
+
+}  // namespace poafloc::bench
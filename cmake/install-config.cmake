@@ -1,5 +1,6 @@
 include(CMakeFindDependencyMacro)
 find_dependency(based)
+find_dependency(Threads)
 
 if(based_FOUND)
   include("${CMAKE_CURRENT_LIST_DIR}/poaflocTargets.cmake")
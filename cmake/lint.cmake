@@ -13,6 +13,7 @@ default(
     include/*.hpp
     test/*.cpp test/*.hpp
     example/*.cpp example/*.hpp
+    bench/*.cpp bench/*.hpp
 )
 default(FIX NO)
 
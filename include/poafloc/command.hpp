@@ -0,0 +1,227 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <based/utility/move.hpp>
+
+#include "poafloc/error.hpp"
+#include "poafloc/poafloc.hpp"
+
+namespace poafloc
+{
+
+// Subcommand of a multi-tool binary. Make returns the parser<Record> of
+// the subcommand, and is only called for the one that was selected, Run
+// is then given the parsed Record and returns the exit code.
+template<class Make, class Run>
+class command
+{
+  std::string_view m_name;
+  Make m_make;
+  Run m_run;
+  std::string_view m_message;
+
+public:
+  using parser_type = std::invoke_result_t<const Make&>;
+  using record_type = typename parser_type::record_type;
+
+  static_assert(std::is_invocable_r_v<int, const Run&, record_type&>);
+
+  constexpr command(
+      std::string_view name, Make make, Run run, std::string_view message
+  )
+      : m_name(name)
+      , m_make(based::move(make))
+      , m_run(based::move(run))
+      , m_message(message)
+  {
+  }
+
+  [[nodiscard]] constexpr std::string_view name() const { return m_name; }
+  [[nodiscard]] constexpr std::string_view message() const
+  {
+    return m_message;
+  }
+
+  // argv[0] is the name of the subcommand
+  int operator()(int argc, const char* const* argv) const
+  {
+    const parser_type program = std::invoke(m_make);
+
+    record_type record = {};
+    const auto res = program.try_parse(record, argc, argv);
+    if (!res.has_value()) {
+      if (res.error().code == error_code::help) {
+        return 0;
+      }
+      program.raise(res.error());
+    }
+
+    return std::invoke(m_run, record);
+  }
+};
+
+namespace detail
+{
+
+struct command_info
+{
+  std::string_view name;
+  std::string_view message;
+};
+
+void help_commands(
+    std::string_view program, std::span<const command_info> commands
+);
+
+}  // namespace detail
+
+// Selects the subcommand named by argv[1] through a perfect hash, built
+// when the table is constructed (at compile time for a constexpr table),
+// so the cost of a run doesn't depend on the number of subcommands
+template<class... Commands>
+class commands
+{
+  static constexpr std::size_t size = sizeof...(Commands);
+
+  // at most half full, so a seed without collisions is found in few tries
+  static constexpr std::size_t table_size = std::bit_ceil(2 * size);
+
+  using run_type = int (*)(const commands&, int, const char* const*);
+
+  std::tuple<Commands...> m_commands;
+  std::array<std::string_view, size> m_names = {};
+  std::array<std::size_t, table_size> m_table = {};  // index + 1, 0 if free
+  std::uint64_t m_seed = 0;
+
+  static constexpr std::uint64_t hash(
+      std::string_view name, std::uint64_t seed
+  )
+  {
+    // NOLINTBEGIN(*magic*)
+    auto res = 0xcbf29ce484222325U ^ (seed * 0x9e3779b97f4a7c15U);
+    for (const auto chr : name) {
+      res = (res ^ static_cast<unsigned char>(chr)) * 0x100000001b3U;
+    }
+    return res ^ (res >> 29U);
+    // NOLINTEND(*magic*)
+  }
+
+  static constexpr std::size_t slot(std::string_view name, std::uint64_t seed)
+  {
+    return static_cast<std::size_t>(hash(name, seed)) & (table_size - 1);
+  }
+
+  constexpr bool try_seed(std::uint64_t seed)
+  {
+    m_table = {};
+    for (std::size_t idx = 0; idx < size; idx++) {
+      auto& entry = m_table[slot(m_names[idx], seed)];
+      if (entry != 0) {
+        return false;
+      }
+      entry = idx + 1;
+    }
+    m_seed = seed;
+    return true;
+  }
+
+  template<std::size_t Idx>
+  static int run(const commands& self, int argc, const char* const* argv)
+  {
+    return std::get<Idx>(self.m_commands)(argc, argv);
+  }
+
+  static constexpr auto runs =
+      []<std::size_t... Idx>(std::index_sequence<Idx...>)
+  {
+    return std::array<run_type, size> {&run<Idx>...};
+  }(std::index_sequence_for<Commands...> {});
+
+  [[nodiscard]] std::array<detail::command_info, size> info() const
+  {
+    return std::apply(
+        [](const auto&... cmds)
+        {
+          return std::array<detail::command_info, size> {
+              detail::command_info {cmds.name(), cmds.message()}...
+          };
+        },
+        m_commands
+    );
+  }
+
+public:
+  constexpr explicit commands(Commands... cmds)
+      : m_commands(based::move(cmds)...)
+  {
+    std::apply(
+        [this](const auto&... cmd)
+        {
+          m_names = {cmd.name()...};
+        },
+        m_commands
+    );
+
+    for (std::size_t i = 0; i < size; i++) {
+      for (std::size_t j = 0; j < i; j++) {
+        if (m_names[i] == m_names[j]) {
+          throw error<error_code::duplicate_command>(m_names[i]);
+        }
+      }
+    }
+
+    std::uint64_t seed = 0;
+    while (!try_seed(seed)) {
+      seed++;
+    }
+  }
+
+  // index of the subcommand, in the order they were given
+  [[nodiscard]] constexpr std::optional<std::size_t> find(
+      std::string_view name
+  ) const
+  {
+    const auto entry = m_table[slot(name, m_seed)];
+    if (entry == 0 || m_names[entry - 1] != name) {
+      return {};
+    }
+    return entry - 1;
+  }
+
+  // Runs the subcommand named by argv[1], with argv[1] as its program
+  // name, and returns its exit code. --help lists the subcommands
+  int operator()(int argc, const char* const* argv) const
+  {
+    const std::string_view program = argc > 0 ? argv[0] : "";
+    if (argc < 2) {
+      detail::help_commands(program, info());
+      throw error<error_code::missing_command>();
+    }
+
+    const std::string_view name = argv[1];
+    if (name == "--help") {
+      detail::help_commands(program, info());
+      return 0;
+    }
+
+    const auto idx = find(name);
+    if (!idx.has_value()) {
+      throw error<error_code::unknown_command>(name);
+    }
+
+    return runs[*idx](*this, argc - 1, argv + 1);  // NOLINT(*pointer*)
+  }
+};
+
+}  // namespace poafloc
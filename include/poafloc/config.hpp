@@ -0,0 +1,29 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <string_view>
+
+namespace poafloc
+{
+
+// Contents of a config file, memory mapped where possible, to be handed to
+// parser::load. Nothing is copied, lines and the tokens of errors view into
+// the mapping, which lives as long as the config_file:
+//
+//   const poafloc::config_file file("app.ini");
+//   program.load(record, file.text());
+//   program(record, argc, argv);  // the command line overrides the file
+class config_file
+{
+  std::shared_ptr<const char> m_owner;
+  std::string_view m_text;
+
+public:
+  // throws error<error_code::unreadable_config> if the file can't be read
+  explicit config_file(const std::filesystem::path& path);
+
+  [[nodiscard]] std::string_view text() const { return m_text; }
+};
+
+}  // namespace poafloc
@@ -0,0 +1,384 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <charconv>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+#include <based/concepts/is/same.hpp>
+
+#include "poafloc/error.hpp"
+
+namespace poafloc
+{
+
+/*
+ * Conversion of option and argument values to their member types.
+ *
+ * Lookup order for a type T:
+ *   1) bool from_string(std::string_view, T&) found by ADL,
+ *   2) integers through std::from_chars, accepting an optional sign and
+ *      0x (hex), 0o (octal) or 0b (binary) prefix, long decimal ones
+ *      eight digits at a time,
+ *   3) floating point values through std::from_chars, except for plain
+ *      decimals that a single division rounds correctly,
+ *   4) types constructible from std::string_view,
+ *   5) operator>> on an std::istream as the last resort.
+ *
+ * The whole value has to be consumed, otherwise it is rejected.
+ */
+
+template<class T>
+concept UserConvertible = requires(std::string_view value, T& out) {
+  { from_string(value, out) } -> std::convertible_to<bool>;
+};
+
+namespace detail
+{
+
+template<class T>
+concept Character = based::SameAs<T, char> || based::SameAs<T, wchar_t>
+    || based::SameAs<T, char8_t> || based::SameAs<T, char16_t>
+    || based::SameAs<T, char32_t>;
+
+template<class T>
+concept Integer =
+    std::integral<T> && !based::SameAs<T, bool> && !Character<T>;
+
+template<class T>
+concept Streamable = requires(std::istream& ist, T& out) { ist >> out; };
+
+constexpr bool strip_sign(std::string_view& value)
+{
+  if (value.empty() || (value.front() != '-' && value.front() != '+')) {
+    return false;
+  }
+
+  const bool negative = value.front() == '-';
+  value.remove_prefix(1);
+  return negative;
+}
+
+constexpr int strip_base(std::string_view& value)
+{
+  if (std::size(value) < 3 || value[0] != '0') {
+    return 10;  // NOLINT(*magic*)
+  }
+
+  int base = 0;
+  switch (value[1]) {
+    case 'x':
+    case 'X':
+      base = 16;  // NOLINT(*magic*)
+      break;
+    case 'o':
+    case 'O':
+      base = 8;  // NOLINT(*magic*)
+      break;
+    case 'b':
+    case 'B':
+      base = 2;
+      break;
+    default:
+      return 10;  // NOLINT(*magic*)
+  }
+
+  value.remove_prefix(2);
+  return base;
+}
+
+// Decimal digits are checked and combined eight at a time, within a 64-bit
+// word, instead of one multiplication and overflow check for each digit.
+// Long runs of numbers, such as parameter sweeps, are dominated by this.
+inline constexpr std::size_t word_digits = 8;
+
+// at most 19 digits, so that the value can't overflow
+inline constexpr std::size_t max_decimal = 19;
+
+template<class T>
+T load(const char* ptr)
+{
+  T res = 0;
+  std::memcpy(&res, ptr, sizeof(T));
+  return res;
+}
+
+// NOLINTBEGIN(*magic*)
+inline bool parse_word(std::uint64_t word, std::uint64_t& out)
+{
+  static constexpr std::uint64_t zeros = 0x3030303030303030U;
+  static constexpr std::uint64_t high = 0xF0F0F0F0F0F0F0F0U;
+  static constexpr std::uint64_t nines = 0x0606060606060606U;
+  static constexpr std::uint64_t mask = 0x000000FF000000FFU;
+
+  // every byte is between '0' and '9'
+  if ((word & high) != zeros || ((word + nines) & high) != zeros) {
+    return false;
+  }
+
+  // pairs of digits, then groups of four, then all eight
+  word -= zeros;
+  word = (word * 10) + (word >> 8U);
+  out = (((word & mask) * (100 + (1000000ULL << 32U)))
+         + (((word >> 16U) & mask) * (1 + (10000ULL << 32U))))
+      >> 32U;
+  return true;
+}
+// NOLINTEND(*magic*)
+
+// value of word_digits to max_decimal digits, false if any of them isn't
+// one. Whole words are taken from the front, the rest one at a time.
+inline bool parse_words(std::string_view digits, std::uint64_t& out)
+{
+  static constexpr std::uint64_t word_scale = 100'000'000;
+
+  std::uint64_t res = 0;
+  while (std::size(digits) >= word_digits) {
+    std::uint64_t word = 0;
+    if (!parse_word(load<std::uint64_t>(digits.data()), word)) {
+      return false;
+    }
+    res = (res * word_scale) + word;
+    digits.remove_prefix(word_digits);
+  }
+
+  for (const auto chr : digits) {
+    if (chr < '0' || chr > '9') {
+      return false;
+    }
+    res = (res * 10U) + static_cast<std::uint64_t>(chr - '0');  // NOLINT
+  }
+
+  out = res;
+  return true;
+}
+
+// numbers shorter than a word are read faster by from_chars
+inline bool is_long_decimal(std::string_view digits)
+{
+  return std::endian::native == std::endian::little
+      && std::size(digits) >= word_digits && std::size(digits) <= max_decimal;
+}
+
+template<class T>
+std::errc parse_magnitude(std::string_view value, int base, T& out)
+{
+  if (base == 10 && is_long_decimal(value)) {  // NOLINT(*magic*)
+    std::uint64_t res = 0;
+    if (!parse_words(value, res)) {
+      return std::errc::invalid_argument;
+    }
+
+    if (res > std::numeric_limits<T>::max()) {
+      return std::errc::result_out_of_range;
+    }
+
+    out = static_cast<T>(res);
+    return {};
+  }
+
+  const auto* end = value.data() + std::size(value);  // NOLINT(*pointer*)
+  const auto [ptr, err] = std::from_chars(value.data(), end, out, base);
+  if (err != std::errc {}) {
+    return err;
+  }
+
+  return ptr != end ? std::errc::invalid_argument : std::errc {};
+}
+
+template<Integer T>
+std::errc convert_integer(std::string_view value, T& out)
+{
+  using unsigned_type = std::make_unsigned_t<T>;
+
+  const bool negative = strip_sign(value);
+  const int base = strip_base(value);
+
+  // sign is already consumed, from_chars would accept another '-'
+  if (value.empty() || value.front() == '-' || value.front() == '+') {
+    return std::errc::invalid_argument;
+  }
+
+  unsigned_type magnitude = 0;
+  if (const auto err = parse_magnitude(value, base, magnitude);
+      err != std::errc {})
+  {
+    return err;
+  }
+
+  if constexpr (std::is_signed_v<T>) {
+    static constexpr auto max = static_cast<unsigned_type>(
+        std::numeric_limits<T>::max()
+    );
+    if (magnitude > max + (negative ? 1U : 0U)) {
+      return std::errc::result_out_of_range;
+    }
+
+    out = negative ? static_cast<T>(static_cast<unsigned_type>(0U - magnitude))
+                   : static_cast<T>(magnitude);
+  } else {
+    if (negative && magnitude != 0) {
+      return std::errc::result_out_of_range;
+    }
+
+    out = magnitude;
+  }
+
+  return {};
+}
+
+template<Streamable T>
+std::errc convert_stream(std::string_view value, T& out)
+{
+  auto istr = std::istringstream(std::string(value));
+  if (!(istr >> out) || !(istr >> std::ws).eof()) {
+    return std::errc::invalid_argument;
+  }
+  return {};
+}
+
+// Plain decimals, such as 0.125, whose digits fit into the mantissa, are
+// the quotient of two exactly represented values, and so correctly rounded
+// by a single division. Everything else is left to from_chars.
+template<std::floating_point T>
+bool convert_decimal(std::string_view value, T& out)
+{
+  // NOLINTBEGIN(*magic*)
+  static constexpr std::array<double, 23> powers = {
+      1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+      1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+      1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+  };
+  static constexpr std::size_t max_exact = sizeof(T) == 4 ? 10 : 22;
+  // NOLINTEND(*magic*)
+
+  using limits = std::numeric_limits<T>;
+  if constexpr (!limits::is_iec559 || limits::digits > 53) {  // NOLINT
+    return false;
+  } else {
+    const bool negative = !value.empty() && value.front() == '-';
+    if (negative) {
+      value.remove_prefix(1);
+    }
+
+    if (std::size(value) > max_decimal + 1) {
+      return false;
+    }
+
+    // digits before and after the dot, in one pass
+    std::uint64_t mantissa = 0;
+    std::size_t fraction = 0;
+    bool dot = false;
+    for (const auto chr : value) {
+      if (chr == '.' && !dot) {
+        dot = true;
+        continue;
+      }
+      if (chr < '0' || chr > '9') {
+        return false;
+      }
+      mantissa = (mantissa * 10U) + static_cast<std::uint64_t>(chr - '0');
+      fraction += dot ? 1U : 0U;
+    }
+
+    const auto digits = std::size(value) - (dot ? 1U : 0U);
+    const auto whole = digits - fraction;
+    if (whole == 0 || (dot && fraction == 0) || digits > max_decimal
+        || fraction > max_exact
+        || mantissa > (std::uint64_t {1} << unsigned {limits::digits}))
+    {
+      return false;
+    }
+
+    const auto scale = powers[fraction];
+    const auto res = static_cast<T>(mantissa) / static_cast<T>(scale);
+    out = negative ? -res : res;
+    return true;
+  }
+}
+
+template<std::floating_point T>
+std::errc convert_floating(std::string_view value, T& out)
+{
+  // from_chars doesn't accept a leading '+'
+  if (!value.empty() && value.front() == '+') {
+    value.remove_prefix(1);
+    if (value.empty() || value.front() == '-') {
+      return std::errc::invalid_argument;
+    }
+  }
+
+  if (convert_decimal(value, out)) {
+    return {};
+  }
+
+#if defined(__cpp_lib_to_chars)
+  const auto* end = value.data() + std::size(value);  // NOLINT(*pointer*)
+  const auto [ptr, err] = std::from_chars(value.data(), end, out);
+  if (err != std::errc {}) {
+    return err;
+  }
+
+  return ptr != end ? std::errc::invalid_argument : std::errc {};
+#else
+  return convert_stream(value, out);
+#endif
+}
+
+}  // namespace detail
+
+template<class T>
+concept Convertible = UserConvertible<T> || detail::Integer<T>
+    || detail::Character<T> || std::floating_point<T>
+    || std::constructible_from<T, std::string_view> || detail::Streamable<T>;
+
+// Non-throwing conversion, reports failures the same way std::from_chars does
+template<Convertible T>
+std::errc convert(std::string_view value, T& out)
+{
+  if constexpr (UserConvertible<T>) {
+    return from_string(value, out) ? std::errc {} : std::errc::invalid_argument;
+  } else if constexpr (detail::Integer<T>) {
+    return detail::convert_integer(value, out);
+  } else if constexpr (detail::Character<T>) {
+    if (std::size(value) != 1) {
+      return std::errc::invalid_argument;
+    }
+    out = static_cast<T>(value.front());
+    return {};
+  } else if constexpr (std::floating_point<T>) {
+    return detail::convert_floating(value, out);
+  } else if constexpr (std::constructible_from<T, std::string_view>) {
+    out = T(value);
+    return {};
+  } else {
+    return detail::convert_stream(value, out);
+  }
+}
+
+template<Convertible T>
+T convert(std::string_view value)
+{
+  T res = {};
+  const auto err = convert(value, res);
+  if (err == std::errc::result_out_of_range) {
+    throw error<error_code::out_of_range>(value);
+  }
+
+  if (err != std::errc {}) {
+    throw error<error_code::invalid_argument>(value);
+  }
+
+  return res;
+}
+
+}  // namespace poafloc
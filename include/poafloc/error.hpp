@@ -1,7 +1,15 @@
 #pragma once
 
+#include <cstddef>
 #include <format>
+#include <optional>
 #include <stdexcept>
+#include <string_view>
+#include <version>
+
+#if defined(__cpp_lib_expected)
+#  include <expected>
+#endif
 
 #include <based/enum/enum.hpp>
 #include <based/format.hpp>
@@ -15,11 +23,17 @@ namespace poafloc
   help, empty, invalid_option, invalid_positional, invalid_terminal,           \
       missing_option, missing_argument, missing_positional,                    \
       superfluous_argument, superfluous_positional, unknown_option,            \
-      duplicate_option
+      duplicate_option, invalid_argument, out_of_range, unterminated_quote,    \
+      unknown_command, missing_command, duplicate_command, recursive_response, \
+      invalid_environment, invalid_config, unknown_section, unreadable_config
 BASED_DECLARE_ENUM(error_code, based::bu8, 0, ENUM_ERROR)
 BASED_DEFINE_ENUM(error_code, based::bu8, 0, ENUM_ERROR)
 #undef ENUM_ERROR
 
+// number of error codes, the last one above included
+inline constexpr std::size_t error_code_count =
+    static_cast<std::size_t>(error_code::unreadable_config()) + 1;
+
 static constexpr const char* error_get_message(error_code::enum_type error)
 {
   switch (error()) {
@@ -47,6 +61,28 @@ static constexpr const char* error_get_message(error_code::enum_type error)
       return "Unknown option: {}";
     case error_code::duplicate_option():
       return "Duplicate option: {}";
+    case error_code::invalid_argument():
+      return "Invalid argument: {}";
+    case error_code::out_of_range():
+      return "Argument out of range: {}";
+    case error_code::unterminated_quote():
+      return "Unterminated quote: {}";
+    case error_code::unknown_command():
+      return "Unknown command: {}";
+    case error_code::missing_command():
+      return "Missing command";
+    case error_code::duplicate_command():
+      return "Duplicate command: {}";
+    case error_code::recursive_response():
+      return "Response file includes itself: {}";
+    case error_code::invalid_environment():
+      return "Invalid value in environment: {}";
+    case error_code::invalid_config():
+      return "Invalid config line: {}";
+    case error_code::unknown_section():
+      return "Unknown config section: {}";
+    case error_code::unreadable_config():
+      return "Can't read config file: {}";
     default:
       return "poafloc error, should not happen...";
   }
@@ -74,4 +110,54 @@ public:
   }
 };
 
+// Failure reported by the non-throwing parser. The token views into the
+// arguments that were parsed, so it lives only as long as they do.
+struct parse_error
+{
+  error_code::enum_type code;
+  std::size_t index;  // into argv, where 0 is the program name
+  std::string_view token;  // offending (part of the) argument, if any
+};
+
+#if defined(__cpp_lib_expected)
+using parse_result = std::expected<void, parse_error>;
+#else
+// Stand-in for std::expected<void, parse_error> before C++23
+class parse_result
+{
+  std::optional<parse_error> m_error;
+
+public:
+  parse_result() = default;
+
+  explicit parse_result(parse_error err)
+      : m_error(err)
+  {
+  }
+
+  [[nodiscard]] bool has_value() const { return !m_error.has_value(); }
+  explicit operator bool() const { return has_value(); }
+
+  [[nodiscard]] const parse_error& error() const { return *m_error; }
+};
+#endif
+
+namespace detail
+{
+
+inline parse_result make_result(const std::optional<parse_error>& err)
+{
+  if (!err.has_value()) {
+    return {};
+  }
+
+#if defined(__cpp_lib_expected)
+  return std::unexpected(*err);
+#else
+  return parse_result(*err);
+#endif
+}
+
+}  // namespace detail
+
 }  // namespace poafloc
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <based/concepts/is/same.hpp>
+#include <based/trait/integral_constant.hpp>
+#include <based/utility/move.hpp>
+
+#include "poafloc/convert.hpp"
+
+namespace poafloc
+{
+
+// Member whose value is converted on first access instead of while
+// parsing, for values that are expensive to convert and seldom read. The
+// text is kept as a Text: std::string_view by default, which views into
+// the arguments and so has to be read while they are still around, or
+// std::string for a copy, as with parse_session or a reused buffer:
+//
+//   struct arguments
+//   {
+//     poafloc::lazy<std::vector<int>> ids;  // from_string found by ADL
+//     poafloc::lazy<std::filesystem::path, std::string> root;
+//   };
+//
+//   if (args.ids.has_text()) { use(args.ids.get()); }
+//
+// Conversion errors are thrown by get, the same way they are by
+// poafloc::convert, and are thrown again on later calls. The converted
+// value is cached unsynchronized, so a lazy shared by threads has to be
+// read once before it is.
+template<Convertible T, class Text = std::string_view>
+  requires(
+      based::SameAs<Text, std::string_view> || based::SameAs<Text, std::string>
+  )
+class lazy
+{
+  Text m_text = {};
+  bool m_given = false;
+  mutable std::optional<T> m_value;
+
+public:
+  using value_type = T;
+
+  lazy() = default;
+
+  // value when none is given
+  explicit lazy(T init)
+      : m_value(based::move(init))
+  {
+  }
+
+  // called by the parser, each value replaces the one before
+  void assign(std::string_view text)
+  {
+    m_text = Text(text);
+    m_given = true;
+    m_value.reset();
+  }
+
+  [[nodiscard]] bool has_text() const { return m_given; }
+  [[nodiscard]] std::string_view text() const { return m_text; }
+
+  // default constructed if there is neither a text nor an initial value
+  [[nodiscard]] const T& get() const
+  {
+    if (!m_value.has_value()) {
+      m_value.emplace(m_given ? convert<T>(m_text) : T {});
+    }
+    return *m_value;
+  }
+
+  [[nodiscard]] const T& operator*() const { return get(); }
+  [[nodiscard]] const T* operator->() const { return &get(); }
+};
+
+namespace detail
+{
+
+template<class T>
+struct is_lazy : based::false_type
+{
+};
+
+template<class T, class Text>
+struct is_lazy<lazy<T, Text>> : based::true_type
+{
+};
+
+template<class T>
+concept Lazy = is_lazy<T>::value;
+
+}  // namespace detail
+
+}  // namespace poafloc
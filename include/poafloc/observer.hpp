@@ -0,0 +1,84 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <string_view>
+
+#include <based/types/types.hpp>
+
+namespace poafloc
+{
+
+enum class event_kind : based::bu8
+{
+  short_option,  // one option of -abc
+  long_option,  // --name or --name=value
+  value,  // an argument taken by the option before it
+  positional,
+  terminator,  // --
+  end,  // all arguments were taken, only the final checks are left
+};
+
+// A decision of the parser, made known before the setter it leads to runs,
+// so a slow setter shows up as the time until the next event. Views are
+// into the arguments being parsed.
+struct parse_event
+{
+  static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+  event_kind kind = event_kind::end;
+  std::size_t index = 0;  // into argv, the argument count for end
+
+  // options in the order they were declared, for all groups in turn, or
+  // the positional argument that was filled, npos if neither
+  std::size_t option = npos;
+  bool abbreviated = false;  // long name given by a unique prefix
+
+  std::string_view token = {};  // name of the option as given
+  std::string_view value = {};  // empty until there is one
+};
+
+// Anything with on_event(const parse_event&), handed to try_parse:
+//
+//   struct latency
+//   {
+//     void on_event(const poafloc::parse_event& event) { ... }
+//   };
+//
+//   latency obs;
+//   const auto res = program.try_parse(record, args, obs);
+template<class T>
+concept Observer = requires(T& obs, const parse_event& event) {
+  obs.on_event(event);
+};
+
+namespace detail
+{
+
+// The parser itself is compiled once, observers reach it through a call
+// of a function instantiated for their type, while parses that aren't
+// observed never get to it at all
+class observer_ref
+{
+  void* m_obs = nullptr;
+  void (*m_func)(void*, const parse_event&) = nullptr;
+
+public:
+  observer_ref() = default;
+
+  template<Observer Obs>
+  explicit observer_ref(Obs& obs)
+      : m_obs(&obs)
+      , m_func(
+            [](void* ptr, const parse_event& event)
+            { static_cast<Obs*>(ptr)->on_event(event); }
+        )
+  {
+  }
+
+  void operator()(const parse_event& event) const { m_func(m_obs, event); }
+};
+
+}  // namespace detail
+
+}  // namespace poafloc
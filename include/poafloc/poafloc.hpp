@@ -1,14 +1,27 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <functional>
 #include <initializer_list>
 #include <memory>
 #include <optional>
+#include <ranges>
 #include <span>
-#include <sstream>
+#include <stdexcept>
 #include <string>
 #include <string_view>
+#include <type_traits>
+#include <vector>
 
+#include <based/char/character.hpp>
+#include <based/char/is/alpha.hpp>
+#include <based/char/is/alpha_lower.hpp>
+#include <based/char/is/digit.hpp>
 #include <based/concepts/is/same.hpp>
 #include <based/container/array.hpp>
 #include <based/container/vector.hpp>
@@ -19,7 +32,11 @@
 #include <based/utility/forward.hpp>
 #include <based/utility/move.hpp>
 
+#include "poafloc/convert.hpp"
 #include "poafloc/error.hpp"
+#include "poafloc/lazy.hpp"
+#include "poafloc/observer.hpp"
+#include "poafloc/stats.hpp"
 
 namespace poafloc
 {
@@ -29,6 +46,272 @@ using namespace based::literals;  // NOLINT(*namespace*)
 namespace detail
 {
 
+struct short_map
+{
+  constexpr bool operator()(based::character chr) const
+  {
+    return based::is_alpha(chr) || chr == '?';
+  }
+};
+
+struct long_map
+{
+  constexpr bool operator()(based::character chr) const
+  {
+    return based::is_alpha_lower(chr) || based::is_digit(chr);
+  }
+};
+
+constexpr bool is_valid_short(based::character chr)
+{
+  return short_map {}(chr);
+}
+
+constexpr bool is_valid_long(std::string_view opt)
+{
+  return !opt.empty() && based::is_alpha_lower(opt.front())
+      && std::ranges::all_of(
+             opt, [](char chr) { return long_map {}(chr); }
+      );
+}
+
+// upper case letters, digits and underscores, as is usual for the shell
+constexpr bool is_valid_env(std::string_view name)
+{
+  return !name.empty() && !based::is_digit(name.front())
+      && std::ranges::all_of(
+             name,
+             [](char chr)
+             {
+               return (chr >= 'A' && chr <= 'Z') || based::is_digit(chr)
+                   || chr == '_';
+             }
+      );
+}
+
+// Text of an option or group. String literals are referred to where they
+// are, anything else is copied into the arena of the parser once it's
+// built, so it only has to live until then.
+class text
+{
+  std::string_view m_view;
+  bool m_literal = false;
+
+public:
+  template<std::size_t N>
+  consteval text(const char (&str)[N])  // NOLINT(*explicit*, *array*)
+      : m_view(str, N - 1)
+      , m_literal(true)
+  {
+  }
+
+  template<class T>
+    requires(std::is_convertible_v<const T&, std::string_view>
+             && !std::is_array_v<T>)
+  text(const T& str)  // NOLINT(*explicit*)
+      : m_view(str)
+  {
+  }
+
+  // a temporary would be gone before the parser copies it
+  text(std::string&& str) = delete;
+
+  [[nodiscard]] constexpr std::string_view view() const { return m_view; }
+  [[nodiscard]] constexpr bool is_literal() const { return m_literal; }
+};
+
+// One allocation holding the texts of a parser that aren't literals,
+// shared by copies of the parser so that views into it stay valid
+class string_arena
+{
+  std::shared_ptr<char[]> m_data;
+  std::size_t m_size = 0;
+
+public:
+  void reserve(std::size_t size)
+  {
+    if (size != 0) {
+      m_data = std::make_shared<char[]>(size);
+    }
+  }
+
+  // literals are left where they are
+  [[nodiscard]] std::string_view intern(std::string_view str, bool literal)
+  {
+    if (literal || str.empty()) {
+      return str;
+    }
+
+    char* dest = m_data.get() + m_size;
+    std::ranges::copy(str, dest);
+    m_size += std::size(str);
+    return {dest, std::size(str)};
+  }
+};
+
+// Short and long names of an option, as in "f flag", and optionally the
+// environment variable it is also read from, as in "t threads $THREADS"
+class option_names
+{
+  based::character m_opt_short = '\0';
+  std::string_view m_opt_long;
+  std::string_view m_env;
+  bool m_literal = false;
+
+  constexpr void parse(std::string_view opts)
+  {
+    while (!opts.empty()) {
+      const auto pos = opts.find(' ');
+      const auto name = opts.substr(0, pos);
+      opts = pos == std::string_view::npos ? "" : opts.substr(pos + 1);
+
+      if (name.empty()) {
+        continue;
+      }
+
+      if (name.front() == '$') {
+        if (has_env()) {
+          throw error<error_code::duplicate_option>(name);
+        }
+        if (!is_valid_env(name.substr(1))) {
+          throw error<error_code::invalid_option>(name);
+        }
+        m_env = name.substr(1);
+      } else if (std::size(name) == 1) {
+        if (has_opt_short()) {
+          throw error<error_code::duplicate_option>(name);
+        }
+        if (!is_valid_short(name.front())) {
+          throw error<error_code::invalid_option>(name);
+        }
+        m_opt_short = name.front();
+      } else {
+        if (has_opt_long()) {
+          throw error<error_code::duplicate_option>(name);
+        }
+        if (!is_valid_long(name)) {
+          throw error<error_code::invalid_option>(name);
+        }
+        m_opt_long = name;
+      }
+    }
+
+    if (!has_opt_short() && !has_opt_long()) {
+      throw error<error_code::missing_option>();
+    }
+  }
+
+public:
+  // String literals are split and validated at compile time, any error is
+  // reported as a compilation failure
+  template<std::size_t N>
+  consteval option_names(const char (&opts)[N])  // NOLINT(*explicit*, *array*)
+      : m_literal(true)
+  {
+    parse(std::string_view(opts, N - 1));
+  }
+
+  template<class T>
+    requires(std::is_convertible_v<const T&, std::string_view>
+             && !std::is_array_v<T>)
+  option_names(const T& opts)  // NOLINT(*explicit*)
+  {
+    parse(opts);
+  }
+
+  // the names are kept as views until the parser copies them
+  option_names(std::string&& opts) = delete;
+
+  [[nodiscard]] constexpr bool has_opt_long() const
+  {
+    return !m_opt_long.empty();
+  }
+
+  [[nodiscard]] constexpr bool has_opt_short() const
+  {
+    return m_opt_short != '\0';
+  }
+
+  [[nodiscard]] constexpr std::string_view opt_long() const
+  {
+    return m_opt_long;
+  }
+
+  [[nodiscard]] constexpr based::character opt_short() const
+  {
+    return m_opt_short;
+  }
+
+  [[nodiscard]] constexpr bool has_env() const { return !m_env.empty(); }
+  [[nodiscard]] constexpr std::string_view env() const { return m_env; }
+
+  [[nodiscard]] constexpr bool is_literal() const { return m_literal; }
+};
+
+// Setter for one member of a record: a plain function pointer, and the
+// member pointer it was instantiated for stored inline, so calls are not
+// type erased further and copies never allocate
+class setter
+{
+public:
+  // conversion failures are returned the same way std::from_chars does
+  using func_type =
+      std::errc (*)(const void* member, void* record, std::string_view value);
+
+private:
+  // large enough for data and member function pointers of common ABIs
+  using storage_type = std::array<std::byte, 2 * sizeof(void*)>;
+
+  func_type m_func = nullptr;
+  alignas(void*) storage_type m_member = {};
+
+public:
+  template<class Member>
+  setter(func_type func, Member member)
+      : m_func(func)
+  {
+    static_assert(sizeof(Member) <= sizeof(storage_type));
+    static_assert(std::is_trivially_copyable_v<Member>);
+    std::memcpy(m_member.data(), &member, sizeof(Member));
+  }
+
+  // recovers the member pointer passed to the constructor, in m_func
+  template<class Member>
+  static Member get_member(const void* storage)
+  {
+    Member res = {};
+    std::memcpy(&res, storage, sizeof(Member));
+    return res;
+  }
+
+  [[nodiscard]] const void* storage() const { return m_member.data(); }
+
+  [[nodiscard]] std::errc operator()(void* record, std::string_view value) const
+  {
+    return m_func(m_member.data(), record, value);
+  }
+};
+
+// Members that take every value of an option, one element each, as
+// opposed to being converted from a value as a whole
+template<class T>
+concept Container = !UserConvertible<T>
+    && !std::constructible_from<T, std::string_view>
+    && requires { typename T::value_type; }
+    && Convertible<typename T::value_type>
+    && (requires(T& cont, typename T::value_type elem) {
+          cont.push_back(based::move(elem));
+        } || requires(T& cont, typename T::value_type elem) {
+          cont.insert(based::move(elem));
+        });
+
+template<class T>
+concept Reservable = Container<T> && requires(T& cont, std::size_t size) {
+  cont.reserve(size);
+  { cont.size() } -> std::convertible_to<std::size_t>;
+  { cont.capacity() } -> std::convertible_to<std::size_t>;
+};
+
 class option
 {
 public:
@@ -42,75 +325,164 @@ public:
   };
 
 private:
-  using func_type = std::function<void(void*, std::string_view)>;
-
   using size_type = based::u64;
 
   type m_type;
-  func_type m_func;
+  setter m_func;
+
+  // makes room for the values of a list, given their count ahead of time
+  using reserve_type =
+      void (*)(const void* member, void* record, std::size_t count);
+  reserve_type m_reserve = nullptr;
 
   based::character m_opt_short;
-  std::string m_opt_long;
+  bool m_literal_names = true;
+  bool m_literal_help = false;
 
-  std::string m_name;
-  std::string m_message;
+  // views into literals, or into the arena of the parser
+  std::string_view m_opt_long;
+  std::string_view m_env;
+  std::string_view m_name;
+  std::string_view m_message;
 
 protected:
   // used for args
-  explicit option(type opt_type, func_type func, std::string_view help);
+  explicit option(type opt_type, setter func, text help);
 
   // used for options
   explicit option(
       type opt_type,
-      std::string_view opts,
-      func_type func,
-      std::string_view help
+      option_names opts,
+      setter func,
+      text help
   );
 
   template<class Record, class Type, class Member = Type Record::*>
-  static auto create(Member member)
+  static std::errc set(
+      const void* storage, void* record_raw, std::string_view value
+  )
   {
-    return [member](void* record_raw, std::string_view value)
-    {
-      auto* record = static_cast<Record*>(record_raw);
-      if constexpr (std::is_invocable_v<Member, Record, std::string_view>) {
-        std::invoke(member, record, value);
-      } else if constexpr (std::is_invocable_v<Member, Record, Type>) {
-        std::invoke(member, record, convert<Type>(value));
-      } else if constexpr (std::is_assignable_v<Type, std::string_view>) {
-        std::invoke(member, record) = value;
+    const auto member = setter::get_member<Member>(storage);
+    auto* record = static_cast<Record*>(record_raw);
+    if constexpr (std::is_invocable_v<Member, Record, std::string_view>) {
+      std::invoke(member, record, value);
+    } else if constexpr (Lazy<Type>) {
+      std::invoke(member, record).assign(value);  // converted when read
+    } else if constexpr (Container<Type>) {
+      typename Type::value_type res = {};
+      const auto err = poafloc::convert(value, res);
+      if (err != std::errc {}) {
+        return err;
+      }
+
+      auto& cont = std::invoke(member, record);
+      if constexpr (requires { cont.push_back(based::move(res)); }) {
+        cont.push_back(based::move(res));
       } else {
-        std::invoke(member, record) = convert<Type>(value);
+        cont.insert(based::move(res));
       }
-    };
+    } else if constexpr (std::is_invocable_v<Member, Record, Type>) {
+      Type res = {};
+      const auto err = poafloc::convert(value, res);
+      if (err == std::errc {}) {
+        std::invoke(member, record, based::move(res));
+      }
+      return err;
+    } else if constexpr (std::is_assignable_v<Type, std::string_view>) {
+      std::invoke(member, record) = value;
+    } else {
+      Type res = {};
+      const auto err = poafloc::convert(value, res);
+      if (err == std::errc {}) {
+        std::invoke(member, record) = based::move(res);
+      }
+      return err;
+    }
+    return {};
   }
 
-  template<class T>
-  static T convert(std::string_view value)
+  template<class Record, class Type, class Member = Type Record::*>
+  static setter create(Member member)
+  {
+    return {&set<Record, Type, Member>, member};
+  }
+
+  template<class Record, class Type, class Member = Type Record::*>
+  static void reserve_values(
+      const void* storage, void* record, std::size_t count
+  )
   {
-    T tmp;
-    auto istr = std::istringstream(std::string(value));
-    istr >> tmp;
-    return tmp;
+    const auto member = setter::get_member<Member>(storage);
+    auto& cont = std::invoke(member, static_cast<Record*>(record));
+
+    // an option repeated with a few values each time mustn't reallocate on
+    // every run, so the growth stays geometric as with push_back
+    const std::size_t size = std::size(cont);
+    const std::size_t capacity = cont.capacity();
+    if (count > capacity - size) {
+      cont.reserve(std::max(size + count, 2 * capacity));
+    }
+  }
+
+  // for the lists, if their member can reserve
+  template<class Record, class Type>
+  void enable_reserve()
+  {
+    if constexpr (Reservable<Type>) {
+      m_reserve = &reserve_values<Record, Type>;
+    }
   }
 
 public:
   [[nodiscard]] bool has_opt_long() const { return !m_opt_long.empty(); }
   [[nodiscard]] bool has_opt_short() const { return m_opt_short != '\0'; }
 
-  [[nodiscard]] const std::string& opt_long() const { return m_opt_long; }
+  [[nodiscard]] std::string_view opt_long() const { return m_opt_long; }
   [[nodiscard]] based::character opt_short() const { return m_opt_short; }
 
-  [[nodiscard]] const std::string& name() const { return m_name; }
-  [[nodiscard]] const std::string& message() const { return m_message; }
+  // explicitly named environment variable, empty if there is none
+  [[nodiscard]] std::string_view env() const { return m_env; }
+
+  [[nodiscard]] std::string_view name() const { return m_name; }
+  [[nodiscard]] std::string_view message() const { return m_message; }
   [[nodiscard]] type get_type() const { return m_type; }
 
-  void operator()(void* record, std::string_view value) const
+  // size of the texts that the parser has to copy into its arena
+  [[nodiscard]] std::size_t arena_size() const;
+  void intern(string_arena& arena);
+
+  [[nodiscard]] const setter& get_setter() const { return m_func; }
+
+  [[nodiscard]] bool can_reserve() const { return m_reserve != nullptr; }
+  void reserve(void* record, std::size_t count) const
+  {
+    m_reserve(m_func.storage(), record, count);
+  }
+
+  [[nodiscard]] std::errc operator()(void* record, std::string_view value) const
+  {
+    return m_func(record, value);
+  }
+};
+
+// What parsing needs of an option, kept apart from its names and help in
+// a dense array of its own, so that a lookup touches a single cache line
+struct alignas(32) action  // NOLINT(*magic*)
+{
+  setter func;
+  option::type type;
+
+  [[nodiscard]] option::type get_type() const { return type; }
+
+  [[nodiscard]] std::errc operator()(void* record, std::string_view value) const
   {
-    m_func(record, value);
+    return func(record, value);
   }
 };
 
+// Index of an option within its parser, as stored by the lookup tables
+using option_index = based::u16;
+
 template<class T>
 using rec_type = typename based::remove_cvref_t<T>::rec_type;
 
@@ -129,7 +501,7 @@ class argument : public detail::option
 public:
   using rec_type = Record;
 
-  explicit argument(std::string_view name, member_type member)
+  explicit argument(detail::text name, member_type member)
       : base(
             base::type::argument,
             base::template create<Record, Type>(member),
@@ -149,11 +521,12 @@ class argument_list : public detail::option
 public:
   using rec_type = Record;
 
-  explicit argument_list(std::string_view name, member_type member)
+  explicit argument_list(detail::text name, member_type member)
       : base(
             base::type::list, base::template create<Record, Type>(member), name
         )
   {
+    base::template enable_reserve<Record, Type>();
   }
 };
 
@@ -168,7 +541,7 @@ public:
   using rec_type = Record;
 
   explicit direct(
-      std::string_view opts, member_type member, std::string_view help
+      detail::option_names opts, member_type member, detail::text help
   )
       : base(
             base::type::direct,
@@ -186,31 +559,31 @@ class boolean : public detail::option
   using base = detail::option;
   using member_type = Type Record::*;
 
-  static auto create(member_type member)
+  static std::errc set(
+      const void* storage, void* record_raw, std::string_view value
+  )
   {
-    return [member](void* record_raw, std::string_view value)
-    {
-      auto* record = static_cast<Record*>(record_raw);
-      if constexpr (std::is_invocable_v<member_type, Record, std::string_view>)
-      {
-        std::invoke(member, record, value);
-      } else if constexpr (std::is_invocable_v<member_type, Record, bool>) {
-        std::invoke(member, record, true);
-      } else if constexpr (std::is_assignable_v<Type, std::string_view>) {
-        std::invoke(member, record) = value;
-      } else {
-        std::invoke(member, record) = true;
-      }
-    };
+    const auto member = detail::setter::get_member<member_type>(storage);
+    auto* record = static_cast<Record*>(record_raw);
+    if constexpr (std::is_invocable_v<member_type, Record, std::string_view>) {
+      std::invoke(member, record, value);
+    } else if constexpr (std::is_invocable_v<member_type, Record, bool>) {
+      std::invoke(member, record, true);
+    } else if constexpr (std::is_assignable_v<Type, std::string_view>) {
+      std::invoke(member, record) = value;
+    } else {
+      std::invoke(member, record) = true;
+    }
+    return {};
   }
 
 public:
   using rec_type = Record;
 
   explicit boolean(
-      std::string_view opts, member_type member, std::string_view help
+      detail::option_names opts, member_type member, detail::text help
   )
-      : base(base::type::boolean, opts, create(member), help)
+      : base(base::type::boolean, opts, {&set, member}, help)
   {
   }
 };
@@ -226,7 +599,7 @@ public:
   using rec_type = Record;
 
   explicit list(
-      std::string_view opts, member_type member, std::string_view help
+      detail::option_names opts, member_type member, detail::text help
   )
       : base(
             base::type::list,
@@ -235,6 +608,7 @@ public:
             help
         )
   {
+    base::template enable_reserve<Record, Type>();
   }
 };
 
@@ -335,11 +709,11 @@ class group_base : public based::vector<detail::option, based::u64>
 {
   using base = based::vector<option, based::u64>;
 
-  std::string m_name;
+  text m_name = std::string_view();
 
 protected:
   template<detail::IsOption Opt, detail::IsOption... Opts>
-  explicit group_base(std::string_view name, Opt&& opt, Opts&&... opts)
+  explicit group_base(text name, Opt&& opt, Opts&&... opts)
       : base(std::initializer_list<option> {
             based::forward<Opt>(opt),
             based::forward<Opts>(opts)...,
@@ -351,7 +725,16 @@ protected:
 public:
   group_base() = default;
 
-  [[nodiscard]] const auto& name() const { return m_name; }
+  [[nodiscard]] const text& name() const { return m_name; }
+
+  [[nodiscard]] std::size_t arena_size() const
+  {
+    auto res = m_name.is_literal() ? 0 : std::size(m_name.view());
+    for (const auto& option : *this) {
+      res += option.arena_size();
+    }
+    return res;
+  }
 };
 
 }  // namespace detail
@@ -362,7 +745,7 @@ struct group : detail::group_base
   using rec_type = Record;
 
   template<detail::IsOption Opt, detail::IsOption... Opts>
-  explicit group(std::string_view name, Opt&& opt, Opts&&... opts)
+  explicit group(detail::text name, Opt&& opt, Opts&&... opts)
     requires detail::SameRec<Opt, Opts...>
       : group_base(
             name, based::forward<Opt>(opt), based::forward<Opts>(opts)...
@@ -372,7 +755,7 @@ struct group : detail::group_base
 };
 
 template<detail::IsOption Opt, detail::IsOption... Opts>
-group(std::string_view name, Opt&& opt, Opts&&... opts)
+group(detail::text name, Opt&& opt, Opts&&... opts)
     -> group<typename Opt::rec_type>;
 
 namespace detail
@@ -381,7 +764,7 @@ namespace detail
 class option_short
 {
   using size_type = based::u8;
-  using value_type = based::u64;
+  using value_type = option_index;
   using opt_type = std::optional<value_type>;
 
   static constexpr auto size = size_type(2_u * 26_u);
@@ -395,86 +778,444 @@ class option_short
 public:
   option_short() { m_opts.fill(sentinel); }
 
-  static constexpr bool is_valid(based::character chr);
+  static constexpr bool is_valid(based::character chr)
+  {
+    return is_valid_short(chr);
+  }
+
   [[nodiscard]] bool set(based::character chr, value_type value);
   [[nodiscard]] opt_type get(based::character chr) const;
+
+  // same as get, except that invalid names are not found instead of thrown
+  [[nodiscard]] opt_type find(based::character chr) const;
 };
 
 class trie_t
 {
   using size_type = based::u8;
-  using value_type = based::u64;
+  using index_type = based::u32;
+  using value_type = option_index;
   using opt_type = std::optional<value_type>;
 
   static constexpr auto size = size_type(26_u + 10_u);
   static constexpr const auto sentinel = based::limits<value_type>::max;
 
-  using ptr_type = std::unique_ptr<trie_t>;
-  using array_type = based::array<ptr_type, size_type, size>;
-  array_type m_children = {};
+  struct node
+  {
+    value_type value = sentinel;
+    based::u8 count = 0_u8;
+    bool terminal = false;
+  };
 
-  value_type m_value = sentinel;
-  based::u8 m_count = 0_u8;
+  // Row of size children per node, each holding the offset of the child's
+  // row. Root can't be a child so 0 marks a missing one. Storing offsets
+  // instead of node numbers leaves a single add and load per character.
+  based::vector<index_type, index_type> m_children;
+  based::vector<node, index_type> m_nodes;
 
-  bool m_terminal = false;
-  trie_t* m_parent = nullptr;
+public:
+  trie_t() { (void)add_node(); }
 
-  static constexpr auto map(based::character chr);
+  [[nodiscard]] index_type add_node();
 
-public:
-  explicit trie_t(trie_t* parent = nullptr)
-      : m_parent(parent)
+  // one node per character is the upper bound, shared prefixes need less
+  static void reserve(trie_t& trie, std::size_t keys_size);
+  static bool set(trie_t& trie, std::string_view key, value_type value);
+  static opt_type get(const trie_t& trie, std::string_view key);
+};
+
+// Hash and displace perfect hash for exact matches of known keys
+class perfect_hash
+{
+  using value_type = option_index;
+  using opt_type = std::optional<value_type>;
+
+  // keys longer than a slot can hold are left to the trie
+  static constexpr std::size_t max_key = 0xFFFF;
+
+  struct slot
+  {
+    std::uint32_t offset = 0;
+    std::uint16_t size = 0;  // keys are never empty, 0 marks a free slot
+    value_type value = 0_u16;
+  };
+
+  std::vector<std::uint32_t> m_seeds;  // displacement of each bucket
+  std::vector<slot> m_slots;
+  std::uint64_t m_mask = 0;
+
+  std::vector<slot> m_pending;  // inserted, but not yet built
+  std::string m_keys;
+
+  // word at a time, long names cost a handful of multiplications
+  static std::uint64_t hash(std::string_view key)
   {
+    static constexpr std::uint64_t prime = 0x9fb21c651e98df25U;
+
+    auto res = std::uint64_t {std::size(key)};
+    while (std::size(key) >= sizeof(std::uint64_t)) {
+      std::uint64_t word = 0;
+      std::memcpy(&word, key.data(), sizeof(word));
+      res = std::rotl((res ^ word) * prime, 29);  // NOLINT(*magic*)
+      key.remove_prefix(sizeof(word));
+    }
+
+    std::uint64_t word = 0;
+    for (std::size_t i = 0; i < std::size(key); i++) {
+      word |= std::uint64_t {static_cast<unsigned char>(key[i])} << (8U * i);
+    }
+    return (res ^ word) * prime;
   }
 
-  static bool set(trie_t& trie, std::string_view key, value_type value);
-  static opt_type get(const trie_t& trie, std::string_view key);
+  // maps hash into [0, size) without a division
+  static std::size_t reduce(std::uint64_t hsh, std::size_t size)
+  {
+    return static_cast<std::size_t>(((hsh >> 32U) * size) >> 32U);
+  }
+
+  static constexpr std::uint64_t mix(std::uint64_t hsh, std::uint32_t seed)
+  {
+    // NOLINTBEGIN(*magic*)
+    hsh ^= seed * 0x9e3779b97f4a7c15U;
+    hsh ^= hsh >> 33U;
+    hsh *= 0xff51afd7ed558ccdU;
+    hsh ^= hsh >> 33U;
+    hsh *= 0xc4ceb9fe1a85ec53U;
+    hsh ^= hsh >> 33U;
+    // NOLINTEND(*magic*)
+    return hsh;
+  }
+
+  [[nodiscard]] std::string_view key(const slot& slt) const
+  {
+    return std::string_view(m_keys).substr(slt.offset, slt.size);
+  }
+
+public:
+  void reserve(std::size_t keys, std::size_t keys_size);
+  void insert(std::string_view key, value_type value);
+  void build();
+
+  [[nodiscard]] opt_type get(std::string_view key) const
+  {
+    if (m_slots.empty()) {
+      return {};
+    }
+
+    const auto hsh = hash(key);
+    const auto seed = m_seeds[reduce(hsh, std::size(m_seeds))];
+    const auto& slt = m_slots[mix(hsh, seed) & m_mask];
+    if (slt.size == 0 || slt.size != std::size(key) || this->key(slt) != key)
+    {
+      return {};
+    }
+
+    return slt.value;
+  }
 };
 
 class option_long
 {
-  using value_type = based::u64;
+  using value_type = option_index;
   using opt_type = std::optional<value_type>;
 
   trie_t m_trie;
+  perfect_hash m_exact;
 
 public:
-  static constexpr bool is_valid(std::string_view opt);
+  static constexpr bool is_valid(std::string_view opt)
+  {
+    return is_valid_long(opt);
+  }
+
+  void reserve(std::size_t opts, std::size_t opts_size);
   [[nodiscard]] bool set(std::string_view opt, value_type idx);
+  void build();
+
   [[nodiscard]] opt_type get(std::string_view opt) const;
+
+  // same as get, except that invalid names are not found instead of thrown
+  [[nodiscard]] opt_type find(std::string_view opt) const;
 };
 
+enum class arg_type : based::bu8
+{
+  positional,
+  dash,
+  terminator,
+  short_opts,
+  long_opt,
+};
+
+// Everything the parser needs to know about an argument before looking
+// at its contents, worked out once per argument
+struct arg_class
+{
+  std::size_t equal = std::string_view::npos;  // first '=' of a long option
+  arg_type type = arg_type::positional;
+};
+
+constexpr arg_type classify_type(std::string_view arg)
+{
+  if (std::size(arg) < 2 || arg[0] != '-') {
+    return arg == "-" ? arg_type::dash : arg_type::positional;
+  }
+
+  if (arg[1] != '-') {
+    return arg_type::short_opts;
+  }
+
+  return std::size(arg) == 2 ? arg_type::terminator : arg_type::long_opt;
+}
+
+constexpr arg_class classify(std::string_view arg)
+{
+  const auto type = classify_type(arg);
+  return {
+      type == arg_type::long_opt ? arg.find('=', 2) : std::string_view::npos,
+      type,
+  };
+}
+
+}  // namespace detail
+
+// One command line, program name first, as handed to main
+using argv_view = std::span<const char* const>;
+
+template<class Record>
+class parse_session;
+
+namespace detail
+{
+
+// Tokens of reported errors view into the arguments, so a range has to
+// yield references to, or views of, strings that outlive the parse. An
+// owning range passed as a temporary would be gone by then.
+template<class R>
+concept ArgumentRange = std::ranges::input_range<R>
+    && (std::ranges::borrowed_range<R> || std::is_lvalue_reference_v<R>)
+    && std::convertible_to<std::ranges::range_reference_t<R>, std::string_view>
+    && (std::is_lvalue_reference_v<std::ranges::range_reference_t<R>>
+        || std::is_pointer_v<std::ranges::range_value_t<R>>
+        || based::SameAs<std::ranges::range_value_t<R>, std::string_view>);
+
+// Element type of the arrays the parser walks without a call per argument
+template<class R>
+using contiguous_argument = std::conditional_t<
+    std::is_pointer_v<std::ranges::range_value_t<R>>,
+    const char*,
+    std::remove_cv_t<std::ranges::range_value_t<R>>>;
+
+template<class R>
+concept ContiguousArgumentRange = ArgumentRange<R>
+    && std::ranges::contiguous_range<R> && std::ranges::sized_range<R>
+    && (based::SameAs<contiguous_argument<R>, const char*>
+        || based::SameAs<contiguous_argument<R>, std::string_view>
+        || based::SameAs<contiguous_argument<R>, std::string>);
+
 class parser_base
 {
+  template<class Record>
+  friend class poafloc::parse_session;
+
   using size_type = based::u64;
 
+  // texts of the options and groups below that aren't literals
+  string_arena m_arena;
+
+  // hot, what parsing needs, and cold, names and help, same indices
+  based::vector<action, size_type> m_actions;
   based::vector<option, size_type> m_options;
 
-  using group_type = std::pair<size_type, std::string>;
+  using group_type = std::pair<size_type, std::string_view>;
   based::vector<group_type, size_type> m_groups;
 
   positional_base m_pos;
   option_short m_opt_short;
   option_long m_opt_long;
 
+  // environment variables options are also read from, sorted by name
+  using env_type = std::pair<std::string, size_type>;
+  std::vector<env_type> m_env;
+  std::string m_env_common;  // prefix shared by all of their names
+
+  // rendered help and usage text, shared by copies of the parser
+  struct help_cache;
+  std::shared_ptr<help_cache> m_help = make_help_cache();
+
+  [[nodiscard]] static std::shared_ptr<help_cache> make_help_cache();
+
+  // totals of the parses so far, shared by copies of the parser, only
+  // allocated if instrumented
+  struct stats_sink;
+  std::shared_ptr<stats_sink> m_stats = make_stats_sink();
+
+  [[nodiscard]] static std::shared_ptr<stats_sink> make_stats_sink();
+
   void process(const option& option);
 
-  [[nodiscard]] const option& get_option(based::character opt) const;
-  [[nodiscard]] const option& get_option(std::string_view opt) const;
+  // nullptr if there is no such option
+  [[nodiscard]] const action* get_option(based::character opt) const;
+  [[nodiscard]] const action* get_option(std::string_view opt) const;
+
+  // the informational options are added last, as a group of their own,
+  // and are only ever given on the command line
+  [[nodiscard]] size_type informational_begin() const
+  {
+    return std::size(m_groups) > size_type(1_u)
+        ? m_groups[std::size(m_groups) - size_type(2_u)].first
+        : size_type(0_u);
+  }
+
+  using status = std::optional<parse_error>;
+
+  // Arguments are handled one at a time, so any source of them can be
+  // walked in place
+  struct state
+  {
+    void* record = nullptr;
+    std::string_view program = {};
+    std::size_t index = 0;  // of the next argument
+    size_type count = 0_u;  // positional arguments taken
+
+    const action* pending = nullptr;  // still waiting for its value
+    std::string_view pending_opt = {};
+    std::size_t pending_index = 0;
+    bool pending_taken = false;  // a list already has a value
+
+    bool is_term = false;
+    bool is_positional = false;  // no more options are accepted
+
+    // options set from the command line, tracked only if any of them can
+    // also be read from the environment
+    std::vector<bool> seen = {};
+
+    struct no_stats
+    {
+    };
+    using stats_type = std::conditional_t<instrumented, parse_stats, no_stats>;
+    [[no_unique_address]] stats_type stats = {};
+
+    // only called by the instantiations for observed parses
+    observer_ref observer = {};
+
+    // a list that has just started taking values, for parse_array to
+    // count them ahead of time
+    const option* run = nullptr;
+  };
+
+  // event is a function making the parse_event, never called unless the
+  // parse is observed
+  template<bool Observe, class Event>
+  static void notify(const state& crnt, Event event)
+  {
+    if constexpr (Observe) {
+      crnt.observer(event());
+    }
+  }
+
+  // Instrumentation goes through these two, with generic lambdas that are
+  // never instantiated unless instrumented
+
+  template<class Func>
+  static void instrument(state& crnt, Func func)
+  {
+    if constexpr (instrumented) {
+      func(crnt.stats);
+    }
+  }
+
+  template<class Func>
+  static auto in_phase(
+      state& crnt, parse_stats::phase parse_stats::*member, Func func
+  )
+  {
+    if constexpr (instrumented) {
+      const auto start = parse_stats::clock::now();
+      auto res = func();
+      instrument(
+          crnt,
+          [&](auto& stats)
+          {
+            auto& step = stats.*member;
+            step.time += parse_stats::clock::now() - start;
+            step.count++;
+          }
+      );
+      return res;
+    } else {
+      return func();
+    }
+  }
+
+  // adds a finished parse to the totals, passing its result through
+  [[nodiscard]] status report(state& crnt, status res) const
+  {
+    instrument(crnt, [&](auto& stats) { collect(stats, res); });
+    return res;
+  }
 
-  using next_t = std::span<const std::string_view>;
+  void collect(const parse_stats& stats, const status& res) const;
 
-  next_t hdl_long_opt(
-      std::string_view program, void* record, std::string_view arg, next_t next
+  // the option takes the next argument, or all up to the next option
+  void start_pending(
+      state& crnt, const action& option, std::string_view opt, std::size_t idx
   ) const;
-  next_t hdl_short_opts(
-      std::string_view program, void* record, std::string_view arg, next_t next
+
+  // position of an option among all of them, and whether it was given by
+  // a prefix of its long name
+  [[nodiscard]] std::size_t index_of(const action& option) const;
+  [[nodiscard]] bool is_abbreviation(
+      const action& option, std::string_view opt
+  ) const;
+
+  // get_option and the action of an option, counted and timed if
+  // instrumented
+  [[nodiscard]] const action* lookup(state& crnt, based::character opt) const;
+  [[nodiscard]] const action* lookup(state& crnt, std::string_view opt) const;
+  [[nodiscard]] static status convert(
+      state& crnt, const action& option, std::size_t idx, std::string_view value
+  );
+
+  // the parser is instantiated twice, for parses that are observed and
+  // for those that are not, which have no trace of the observer
+  template<bool Observe = false>
+  [[nodiscard]] status feed(state& crnt, std::string_view arg) const;
+  template<bool Observe = false>
+  [[nodiscard]] status finish(const state& crnt) const;
+
+  // instantiated for the element types of ContiguousArgumentRange only
+  template<class T>
+  [[nodiscard]] status parse_array(void* record, std::span<const T> args) const;
+  template<class T>
+  static void reserve_run(state& crnt, std::span<const T> rest);
+
+  template<bool Observe>
+  [[nodiscard]] status hdl_argument(
+      state& crnt, std::size_t idx, std::string_view arg
   ) const;
-  next_t hdl_short_opt(
-      void* record, based::character opt, std::string_view rest, next_t next
+  template<bool Observe>
+  [[nodiscard]] status hdl_long_opt(
+      state& crnt, std::size_t idx, std::string_view arg, std::size_t equal
   ) const;
+  template<bool Observe>
+  [[nodiscard]] status hdl_short_opts(
+      state& crnt, std::size_t idx, std::string_view arg
+  ) const;
+  template<bool Observe>
+  [[nodiscard]] status hdl_positional(
+      state& crnt, std::size_t idx, std::string_view arg
+  ) const;
+
+  void mark_seen(state& crnt, const action& option) const;
+
+  void build_env(std::string_view prefix);
+  [[nodiscard]] status apply_env(const state& crnt) const;
+
+  void render_usage(std::string& out, std::string_view program) const;
+  void render_long(std::string& out, std::string_view program) const;
+  void render_short(std::string& out, std::string_view program) const;
 
-  void help_usage(std::string_view program) const;
   [[nodiscard]] bool help_long(std::string_view program) const;
   [[nodiscard]] bool help_short(std::string_view program) const;
 
@@ -491,19 +1232,7 @@ protected:
     requires(based::SameAs<group_base, Groups> && ...)
       : m_pos(based::forward<decltype(positional)>(positional))
   {
-    m_options.reserve(m_options.size() + (groups.size() + ...));
-    m_groups.reserve(size_type::underlying_cast(sizeof...(groups)));
-
-    const auto process = [&](const auto& group)
-    {
-      for (const auto& option : group) {
-        this->process(option);
-      }
-      m_groups.emplace_back(m_options.size(), group.name());
-    };
-    (process(groups), ...);
-
-    process(group<parser_base> {
+    const auto help = group<parser_base> {
         "Informational Options",
         boolean {
             "? help",
@@ -515,18 +1244,168 @@ protected:
             &parser_base::help_short,
             "Give a short usage message",
         },
-    });
+    };
+
+    const auto opts = [](const group_base& group)
+    {
+      return static_cast<std::size_t>(std::ranges::count_if(
+          group, [](const auto& option) { return option.has_opt_long(); }
+      ));
+    };
+
+    const auto opts_size = [](const group_base& group)
+    {
+      std::size_t res = 0;
+      for (const auto& option : group) {
+        res += std::size(option.opt_long());
+      }
+      return res;
+    };
+
+    std::size_t arena_size = 0;
+    for (const auto& pos : m_pos) {
+      arena_size += pos.arena_size();
+    }
+    m_arena.reserve(
+        arena_size + (groups.arena_size() + ...) + help.arena_size()
+    );
+    for (auto& pos : m_pos) {
+      pos.intern(m_arena);
+    }
+
+    m_actions.reserve(m_actions.size() + (groups.size() + ...) + help.size());
+    m_options.reserve(m_options.size() + (groups.size() + ...) + help.size());
+    m_groups.reserve(size_type::underlying_cast(sizeof...(groups)));
+    m_opt_long.reserve(
+        (opts(groups) + ... + opts(help)),
+        (opts_size(groups) + ... + opts_size(help))
+    );
+
+    const auto process = [&](const auto& group)
+    {
+      for (const auto& option : group) {
+        this->process(option);
+      }
+      const auto& name = group.name();
+      m_groups.emplace_back(
+          m_options.size(), m_arena.intern(name.view(), name.is_literal())
+      );
+    };
+    (process(groups), ...);
+    process(help);
+
+    m_opt_long.build();
+    build_env({});
   }
 
-  void operator()(void* record, int argc, const char** argv);
-  void operator()(void* record, std::span<const std::string_view> args);
+  // Nothing is thrown for malformed command lines, conversion errors
+  // included, only exceptions from the record's own setters pass through
+  template<ArgumentRange Range>
+  [[nodiscard]] status parse(void* record, Range&& args) const
+  {
+    if constexpr (ContiguousArgumentRange<Range>) {
+      using element_type = const contiguous_argument<Range>;
+      return parse_array(
+          record,
+          std::span<element_type>(
+              std::ranges::data(args), std::ranges::size(args)
+          )
+      );
+    } else {
+      state crnt {.record = record};
+      for (auto&& arg : args) {
+        if (auto res = feed(crnt, std::string_view(arg))) {
+          return report(crnt, res);
+        }
+      }
+      return report(crnt, finish(crnt));
+    }
+  }
+
+  [[nodiscard]] status parse(
+      void* record, int argc, const char* const* argv
+  ) const
+  {
+    return parse(record, std::span(argv, static_cast<std::size_t>(argc)));
+  }
+
+  // every decision is also handed to the observer
+  template<ArgumentRange Range>
+  [[nodiscard]] status parse(
+      void* record, Range&& args, observer_ref observer
+  ) const
+  {
+    state crnt {.record = record, .observer = observer};
+    for (auto&& arg : args) {
+      if (auto res = feed<true>(crnt, std::string_view(arg))) {
+        return report(crnt, res);
+      }
+    }
+    return report(crnt, finish<true>(crnt));
+  }
+
+  // Sets options from the lines of an INI file, see parser::load
+  [[nodiscard]] status load(void* record, std::string_view text) const;
+
+  // Parses lines[i] into the record at records + i * stride, spread over
+  // threads (0 for one per hardware thread). The first exception thrown by
+  // a setter is rethrown once all threads are done
+  [[nodiscard]] std::vector<parse_result> parse_batch(
+      std::span<const argv_view> lines,
+      void* records,
+      std::size_t stride,
+      std::size_t threads
+  ) const;
+
+public:
+  // throws the error the exception based interface reports err with
+  [[noreturn]] void raise(const parse_error& err) const;
+
+  // Options left unset by the command line are also read from environment
+  // variables: the one given with $NAME, or else prefix followed by the
+  // long name in upper case, so "APP_" reads --threads from APP_THREADS.
+  // A boolean is set by any value other than an empty one or 0. The
+  // environment is scanned once per parse, and only if any option can be
+  // read from it. Must be called before the parser is shared by threads.
+  void env_prefix(std::string_view prefix) { build_env(prefix); }
+
+  // Text printed by --help and --usage, rendered on the first request for
+  // a program name and kept for as long as the parser. Only the first few
+  // names are kept, the text of any other one is valid until the thread
+  // asks for another such text.
+  [[nodiscard]] std::string_view help_text(std::string_view program) const;
+  [[nodiscard]] std::string_view usage_text(std::string_view program) const;
+
+  // write the text to a file descriptor with a single write(2), unless it
+  // is cut short, false if writing failed
+  bool write_help(int fd, std::string_view program) const;
+  bool write_usage(int fd, std::string_view program) const;
+
+  // Totals of the parses so far, by any thread, all zero unless
+  // instrumented. take_stats also starts them over, for export at an
+  // interval. Parses that throw from a setter aren't counted.
+  [[nodiscard]] parse_stats stats() const;
+  parse_stats take_stats() const;
+
+protected:
+  // help is not an error for the exception based interface
+  void check(const status& err) const
+  {
+    if (err.has_value() && err->code() != error_code::help()) {
+      raise(*err);
+    }
+  }
 };
 
 }  // namespace detail
 
+// Parsing never modifies a parser, and keeps all of its state on the stack,
+// so one parser can be used by any number of threads at once
 template<class Record>
 struct parser : detail::parser_base
 {
+  using record_type = Record;
+
   template<class Group, class... Groups>
   explicit parser(Group&& grp, Groups&&... groups)
     requires(
@@ -550,22 +1429,192 @@ struct parser : detail::parser_base
   {
   }
 
-  void operator()(Record& record, int argc, const char** argv)
+  void operator()(Record& record, int argc, const char* const* argv) const
+  {
+    check(parse(&record, argc, argv));
+  }
+
+  void operator()(Record& record, std::span<const std::string_view> args) const
+  {
+    check(parse(&record, args));
+  }
+
+  // std::vector<std::string>, std::span<char*> and the like are parsed in
+  // place, without building a vector of views first
+  template<detail::ArgumentRange Range>
+  void operator()(Record& record, Range&& args) const
+  {
+    check(parse(&record, args));
+  }
+
+  // Reports malformed command lines, and displayed help, without throwing
+  [[nodiscard]] parse_result try_parse(
+      Record& record, int argc, const char* const* argv
+  ) const
+  {
+    return detail::make_result(parse(&record, argc, argv));
+  }
+
+  [[nodiscard]] parse_result try_parse(
+      Record& record, std::span<const std::string_view> args
+  ) const
+  {
+    return detail::make_result(parse(&record, args));
+  }
+
+  template<detail::ArgumentRange Range>
+  [[nodiscard]] parse_result try_parse(Record& record, Range&& args) const
   {
-    try {
-      parser_base::operator()(&record, argc, argv);
-    } catch (const error<error_code::help>& err) {
-      (void)err;
+    return detail::make_result(parse(&record, args));
+  }
+
+  // Hands every decision to observer as a parse_event, see Observer
+  template<Observer Obs>
+  [[nodiscard]] parse_result try_parse(
+      Record& record, int argc, const char* const* argv, Obs& observer
+  ) const
+  {
+    const auto args = std::span(argv, static_cast<std::size_t>(argc));
+    return try_parse(record, args, observer);
+  }
+
+  template<detail::ArgumentRange Range, Observer Obs>
+  [[nodiscard]] parse_result try_parse(
+      Record& record, Range&& args, Obs& observer
+  ) const
+  {
+    return detail::make_result(
+        parse(&record, args, detail::observer_ref(observer))
+    );
+  }
+
+  // Sets options from the text of an INI file, a config_file for example.
+  // Each key = value line is handled like --key=value on the command line,
+  // keys may be abbreviated the same way, and a key under a [section] must
+  // belong to the group of that name. A boolean is set by a bare key or by
+  // true, yes, on or 1, and left alone by false, no, off or 0. Lines whose
+  // first character is # or ; are comments, a value may be put in double
+  // quotes to keep its surrounding blanks. The index of an error is its
+  // line number, from 1, and its token views into text.
+  void load(Record& record, std::string_view text) const
+  {
+    check(parser_base::load(&record, text));
+  }
+
+  [[nodiscard]] parse_result try_load(Record& record, std::string_view text)
+      const
+  {
+    return detail::make_result(parser_base::load(&record, text));
+  }
+
+  // Parses lines[i] into records[i], on a work stealing pool of threads
+  // (0 for one per hardware thread), and reports each line on its own
+  [[nodiscard]] std::vector<parse_result> parse_batch(
+      std::span<const argv_view> lines,
+      std::span<Record> records,
+      std::size_t threads = 0
+  ) const
+  {
+    if (std::size(lines) != std::size(records)) {
+      throw std::invalid_argument("poafloc: one record per line is required");
+    }
+
+    return parser_base::parse_batch(
+        lines, std::data(records), sizeof(Record), threads
+    );
+  }
+};
+
+// Push parser: arguments are fed as they arrive, one at a time or in
+// chunks. The session copies what it keeps in between calls, so a stream can
+// be parsed while it is read into a reused buffer, as long as the members
+// that take the values own them. A std::string_view member, or a lazy<T>
+// keeping its text as one, views into the buffer and sees it overwritten by
+// the next call. An option waiting for its value, or a list still taking
+// values, carries over to the next call. The first error ends the session,
+// it's returned from every later call, and its token stays valid for as long
+// as the session does.
+template<class Record>
+class parse_session
+{
+  const parser<Record>* m_parser;
+  detail::parser_base::state m_state;
+
+  // copies of what the state keeps referring to across calls
+  std::string m_program;
+  std::string m_pending;
+  std::string m_token;
+  std::optional<parse_error> m_error;
+
+  parse_result keep(const std::optional<parse_error>& err)
+  {
+    if (!err.has_value()) {
+      return {};
     }
+
+    m_token = err->token;
+    m_error = parse_error {err->code, err->index, m_token};
+    return detail::make_result(m_error);
+  }
+
+public:
+  parse_session(const parser<Record>& program, Record& record)
+      : m_parser(&program)
+      , m_state {.record = &record}
+  {
+  }
+
+  // the state views into the strings of this very session
+  parse_session(const parse_session&) = delete;
+  parse_session(parse_session&&) = delete;
+  parse_session& operator=(const parse_session&) = delete;
+  parse_session& operator=(parse_session&&) = delete;
+  ~parse_session() = default;
+
+  parse_result feed(std::string_view arg)
+  {
+    if (m_error.has_value()) {
+      return detail::make_result(m_error);
+    }
+
+    if (auto err = m_parser->feed(m_state, arg)) {
+      return keep(m_parser->report(m_state, err));
+    }
+
+    if (m_state.index == 1) {
+      m_program = arg;
+      m_state.program = m_program;
+    }
+
+    if (m_state.pending != nullptr
+        && m_state.pending_opt.data() != m_pending.data())
+    {
+      m_pending = m_state.pending_opt;
+      m_state.pending_opt = m_pending;
+    }
+
+    return {};
   }
 
-  void operator()(Record& record, std::span<const std::string_view> args)
+  template<detail::ArgumentRange Range>
+  parse_result feed(Range&& args)
   {
-    try {
-      parser_base::operator()(&record, args);
-    } catch (const error<error_code::help>& err) {
-      (void)err;
+    for (auto&& arg : args) {
+      if (auto res = feed(std::string_view(arg)); !res.has_value()) {
+        return res;
+      }
+    }
+    return {};
+  }
+
+  // reports what is still missing: a value, positional arguments
+  parse_result finish()
+  {
+    if (m_error.has_value()) {
+      return detail::make_result(m_error);
     }
+
+    return keep(m_parser->report(m_state, m_parser->finish(m_state)));
   }
 };
 
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace poafloc
+{
+
+// Expands GNU style @file arguments: each is replaced by the words of the
+// file, split as by tokenizer, and nested @file words are expanded in turn.
+// An @file naming a file that can't be read is kept as is, and a file that
+// includes itself throws error<error_code::recursive_response>.
+//
+// Files are memory mapped and words are views into the mappings, so huge
+// argument lists are never copied. They stay valid until the next expand,
+// and can be handed to a parser as they are:
+//
+//   poafloc::response_files files;
+//   program(record, files.expand(argc, argv));
+class response_files
+{
+  std::vector<std::shared_ptr<const char>> m_files;
+  std::deque<std::string> m_scratch;
+  std::vector<std::string_view> m_args;
+
+  // a file being expanded, and its words that come after the nested file
+  // being expanded in their place
+  struct frame
+  {
+    std::string ident;
+    std::vector<std::string_view> rest;
+    std::size_t next = 0;
+  };
+
+  void splice(std::string_view arg, std::vector<frame>& open);
+  void add(std::string_view arg, std::vector<frame>& open);
+
+  template<class Range>
+  std::span<const std::string_view> expand_range(const Range& args);
+
+public:
+  [[nodiscard]] std::span<const std::string_view> expand(
+      int argc, const char* const* argv
+  );
+  [[nodiscard]] std::span<const std::string_view> expand(
+      std::span<const std::string_view> args
+  );
+};
+
+}  // namespace poafloc
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "poafloc/error.hpp"
+
+namespace poafloc
+{
+
+// Parses are counted and timed only if the library is built with
+// POAFLOC_INSTRUMENT, the poafloc_INSTRUMENT CMake option, and otherwise
+// cost nothing at all. Instrumented, an option takes several times as long
+// to parse, most of it reading the clock.
+#if defined(POAFLOC_INSTRUMENT)
+inline constexpr bool instrumented = true;
+#else
+inline constexpr bool instrumented = false;
+#endif
+
+// Where the time of parsing goes, totalled over the parses of a parser:
+//
+//   const auto stats = program.take_stats();  // and start over
+//   export("lookup_ns", stats.lookup.time.count());
+//   export("unknown", stats.errors_of(poafloc::error_code::unknown_option));
+struct parse_stats
+{
+  using clock = std::chrono::steady_clock;
+
+  // steps of a phase, and the time spent in them, as read by the clock
+  // before and after each one
+  struct phase
+  {
+    std::uint64_t count = 0;
+    clock::duration time = {};
+
+    phase& operator+=(const phase& rhs);
+  };
+
+  std::uint64_t parses = 0;
+  std::uint64_t arguments = 0;  // the program names included
+
+  // arguments by kind, option values taken by the option before excluded
+  std::uint64_t short_clusters = 0;  // -abc counts once
+  std::uint64_t long_options = 0;  // --name
+  std::uint64_t long_values = 0;  // --name=value
+  std::uint64_t values = 0;  // of the option before, --name value
+
+  std::uint64_t abbreviations = 0;  // long names resolved by their prefix
+
+  phase lookup;  // of option names, long and short
+  phase conversion;  // of option values, by their setters
+  phase positional;  // conversion of positional arguments
+
+  // parses that ended with an error, indexed by its error_code
+  std::array<std::uint64_t, error_code_count> errors = {};
+
+  [[nodiscard]] std::uint64_t errors_of(error_code::enum_type code) const
+  {
+    return errors[static_cast<std::size_t>(code())];
+  }
+
+  parse_stats& operator+=(const parse_stats& rhs);
+};
+
+}  // namespace poafloc
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace poafloc
+{
+
+namespace detail
+{
+
+// Appends the words of line to words, the ones that had to be unquoted
+// are put into scratch, which must not change while they are in use
+void split_words(
+    std::string_view line,
+    std::string& scratch,
+    std::vector<std::string_view>& words
+);
+
+}  // namespace detail
+
+// Splits a whole command line into words following the POSIX shell quoting
+// rules: blanks separate words, a backslash escapes the next character,
+// nothing is special inside single quotes, and inside double quotes a
+// backslash escapes only $ ` " \ and a newline. No expansion is done.
+//
+// Words are views into the line wherever the line already holds them as
+// is, and only words that had to be unquoted are copied into a scratch
+// buffer, reused from one line to the next. The result is valid until the
+// next split, and can be handed to a parser as it is:
+//
+//   poafloc::tokenizer tok;
+//   program(record, tok.split(line));
+class tokenizer
+{
+  std::string m_scratch;
+  std::vector<std::string_view> m_words;
+
+public:
+  // throws error<error_code::unterminated_quote> for a quote left open
+  [[nodiscard]] std::span<const std::string_view> split(std::string_view line);
+};
+
+}  // namespace poafloc
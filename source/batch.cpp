@@ -0,0 +1,167 @@
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "poafloc/error.hpp"
+#include "poafloc/poafloc.hpp"
+
+namespace
+{
+
+// lines taken by a worker at once, a line is parsed in well under a
+// microsecond so anything smaller is dominated by the locking
+constexpr std::size_t chunk_size = 32;
+
+using range = std::pair<std::size_t, std::size_t>;
+
+// Lines not yet parsed by one worker: the owner takes chunks from the
+// front, idle workers steal half of what is left from the back
+class range_queue
+{
+  std::mutex m_mutex;
+  std::size_t m_begin = 0;
+  std::size_t m_end = 0;
+
+public:
+  void assign(range rng)
+  {
+    const std::scoped_lock lock(m_mutex);
+    m_begin = rng.first;
+    m_end = rng.second;
+  }
+
+  std::optional<range> pop()
+  {
+    const std::scoped_lock lock(m_mutex);
+    if (m_begin == m_end) {
+      return {};
+    }
+
+    const auto begin = m_begin;
+    m_begin = std::min(m_end, m_begin + chunk_size);
+    return range {begin, m_begin};
+  }
+
+  std::optional<range> steal()
+  {
+    const std::scoped_lock lock(m_mutex);
+    if (m_begin == m_end) {
+      return {};
+    }
+
+    const auto end = m_end;
+    m_end -= (m_end - m_begin + 1) / 2;
+    return range {m_end, end};
+  }
+};
+
+// Nothing is added once started, so a worker that finds every queue empty
+// is done for good
+class work_stealing
+{
+  std::vector<range_queue> m_queues;
+
+public:
+  work_stealing(std::size_t size, std::size_t workers)
+      : m_queues(workers)
+  {
+    for (std::size_t i = 0; i < workers; i++) {
+      m_queues[i].assign({size * i / workers, size * (i + 1) / workers});
+    }
+  }
+
+  template<class Func>
+  void run(std::size_t worker, const std::atomic<bool>& stop, Func func)
+  {
+    auto& own = m_queues[worker];
+    while (!stop.load(std::memory_order_relaxed)) {
+      if (const auto rng = own.pop()) {
+        for (auto idx = rng->first; idx < rng->second; idx++) {
+          func(idx);
+        }
+        continue;
+      }
+
+      std::optional<range> stolen;
+      for (std::size_t i = 1; i < std::size(m_queues) && !stolen; i++) {
+        stolen = m_queues[(worker + i) % std::size(m_queues)].steal();
+      }
+
+      if (!stolen) {
+        return;
+      }
+      own.assign(*stolen);
+    }
+  }
+};
+
+}  // namespace
+
+namespace poafloc::detail
+{
+
+std::vector<parse_result> parser_base::parse_batch(
+    std::span<const argv_view> lines,
+    void* records,
+    std::size_t stride,
+    std::size_t threads
+) const
+{
+  const auto size = std::size(lines);
+  std::vector<parse_result> res(size);
+
+  if (threads == 0) {
+    threads = std::max(1U, std::thread::hardware_concurrency());
+  }
+  const auto chunks = (size + chunk_size - 1) / chunk_size;
+  threads = std::clamp<std::size_t>(chunks, 1, threads);
+
+  std::atomic<bool> stop = false;
+  std::exception_ptr except;
+  std::mutex except_mutex;
+
+  work_stealing work(size, threads);
+  const auto worker = [&](std::size_t wid)
+  {
+    try {
+      work.run(
+          wid,
+          stop,
+          [&](std::size_t idx)
+          {
+            auto* record = static_cast<char*>(records) + (idx * stride);
+            res[idx] = make_result(parse(record, lines[idx]));
+          }
+      );
+    } catch (...) {
+      const std::scoped_lock lock(except_mutex);
+      if (!except) {
+        except = std::current_exception();
+      }
+      stop = true;
+    }
+  };
+
+  {
+    std::vector<std::jthread> pool;
+    pool.reserve(threads - 1);
+    for (std::size_t wid = 1; wid < threads; wid++) {
+      pool.emplace_back(worker, wid);
+    }
+    worker(0);
+  }
+
+  if (except) {
+    std::rethrow_exception(except);
+  }
+
+  return res;
+}
+
+}  // namespace poafloc::detail
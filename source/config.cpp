@@ -0,0 +1,23 @@
+#include <filesystem>
+#include <utility>
+
+#include "poafloc/config.hpp"
+
+#include "mapping.hpp"
+#include "poafloc/error.hpp"
+
+namespace poafloc
+{
+
+config_file::config_file(const std::filesystem::path& path)
+{
+  auto file = detail::map_file(path);
+  if (!file.has_value()) {
+    throw error<error_code::unreadable_config>(path.string());
+  }
+
+  m_owner = std::move(file->owner);
+  m_text = file->text;
+}
+
+}  // namespace poafloc
@@ -0,0 +1,141 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#include "poafloc/error.hpp"
+#include "poafloc/poafloc.hpp"
+
+#if defined(__APPLE__)
+#  include <crt_externs.h>
+#elif defined(_WIN32)
+#  include <stdlib.h>
+#else
+extern "C" char** environ;  // NOLINT(*global*)
+#endif
+
+namespace
+{
+
+const char* const* get_environ()
+{
+#if defined(__APPLE__)
+  return *_NSGetEnviron();
+#elif defined(_WIN32)
+  return _environ;
+#else
+  return environ;
+#endif
+}
+
+std::string to_env(std::string_view prefix, std::string_view opt_long)
+{
+  std::string res(prefix);
+  res.reserve(std::size(prefix) + std::size(opt_long));
+  for (const char chr : opt_long) {
+    res += chr >= 'a' && chr <= 'z' ? static_cast<char>(chr - 'a' + 'A') : chr;
+  }
+  return res;
+}
+
+bool is_enabled(std::string_view value)
+{
+  return !value.empty() && value != "0";
+}
+
+}  // namespace
+
+namespace poafloc::detail
+{
+
+void parser_base::build_env(std::string_view prefix)
+{
+  m_env.clear();
+
+  const auto end = informational_begin();
+  for (auto idx = size_type(0_u); idx < end; idx++) {
+    const auto& opt = m_options[idx];
+    if (!opt.env().empty()) {
+      m_env.emplace_back(opt.env(), idx);
+    } else if (!prefix.empty() && opt.has_opt_long()) {
+      m_env.emplace_back(to_env(prefix, opt.opt_long()), idx);
+    }
+  }
+
+  std::ranges::sort(m_env);
+  const auto dup = std::ranges::adjacent_find(
+      m_env, {}, [](const env_type& env) { return env.first; }
+  );
+  if (dup != m_env.end()) {
+    throw error<error_code::duplicate_option>(dup->first);
+  }
+
+  // sorted, so the first and the last name have the shortest common prefix
+  m_env_common.clear();
+  if (!m_env.empty()) {
+    const auto& first = m_env.front().first;
+    const auto& last = m_env.back().first;
+    const auto [itr, _] = std::ranges::mismatch(first, last);
+    m_env_common.assign(first.begin(), itr);
+  }
+}
+
+void parser_base::mark_seen(state& crnt, const action& option) const
+{
+  if (!crnt.seen.empty()) {
+    crnt.seen[index_of(option)] = true;
+  }
+}
+
+// One pass over the environment, each variable looked up in the sorted
+// index, instead of a getenv scan of the whole environment per option
+parser_base::status parser_base::apply_env(const state& crnt) const
+{
+  const auto common = std::size(m_env_common);
+  for (const auto* const* var = get_environ(); *var != nullptr; var++) {
+    // most of a large environment is rejected on its first characters,
+    // without even measuring the length of the variable
+    if (std::strncmp(*var, m_env_common.c_str(), common) != 0) {
+      continue;
+    }
+
+    const std::string_view entry = *var;
+    const auto equal = entry.find('=');
+    if (equal == std::string_view::npos) {
+      continue;
+    }
+
+    const auto name = entry.substr(0, equal);
+    const auto itr = std::ranges::lower_bound(
+        m_env, name, {}, [](const env_type& env) -> std::string_view
+        { return env.first; }
+    );
+    if (itr == m_env.end() || itr->first != name) {
+      continue;
+    }
+
+    const auto idx = itr->second;
+    if (crnt.seen[static_cast<std::size_t>(idx.value)]) {
+      continue;
+    }
+
+    const auto& opt = m_actions[idx];
+    const auto value = entry.substr(equal + 1);
+    if (opt.get_type() == option::type::boolean) {
+      if (is_enabled(value)) {
+        (void)opt(crnt.record, value);
+      }
+      continue;
+    }
+
+    if (value.empty() || opt(crnt.record, value) != std::errc {}) {
+      return parse_error {error_code::invalid_environment, crnt.index, entry};
+    }
+  }
+
+  return {};
+}
+
+}  // namespace poafloc::detail
@@ -1,26 +1,64 @@
 #include <algorithm>
+#include <cerrno>
+#include <deque>
 #include <format>
-#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
 
 #include "based/algorithms/max.hpp"
+#include "poafloc/command.hpp"
 #include "poafloc/poafloc.hpp"
 
+#if defined(__unix__) || defined(__APPLE__)
+#  include <unistd.h>
+#else
+#  include <io.h>
+#endif
+
 namespace poafloc::detail
 {
 
 namespace
 {
 
-std::string format_option_long(const option& option)
+constexpr int stderr_fd = 2;
+
+// stderr is unbuffered, so the text goes out in one piece instead
+bool write_all(int fd, std::string_view text)
+{
+  while (!text.empty()) {
+#if defined(__unix__) || defined(__APPLE__)
+    const auto res = ::write(fd, text.data(), std::size(text));
+#else
+    const auto res =
+        ::_write(fd, text.data(), static_cast<unsigned>(std::size(text)));
+#endif
+    if (res < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    text.remove_prefix(static_cast<std::size_t>(res));
+  }
+  return true;
+}
+
+void format_option_long(std::string& out, const option& option)
 {
   const auto& opt = option.opt_long();
   switch (option.get_type()) {
     case option::type::boolean:
-      return std::format("--{}", opt);
+      out += std::format("--{}", opt);
+      break;
     case option::type::list:
-      return std::format("--{}={}...", opt, option.name());
+      out += std::format("--{}={}...", opt, option.name());
+      break;
     default:
-      return std::format("--{}={}", opt, option.name());
+      out += std::format("--{}={}", opt, option.name());
+      break;
   }
 }
 
@@ -37,57 +75,117 @@ std::string format_option_short(const option& option)
   }
 }
 
+void pad(std::string& out, std::size_t line_start)
+{
+  static constexpr const auto mid = std::size_t {30};
+  const auto len = std::size(out) - line_start;
+  out.append(based::max(len, mid) - len, ' ');
+}
+
 }  // namespace
 
-void parser_base::help_usage(std::string_view program) const
+// The first few program names, in practice only ever argv[0], are kept
+// for as long as the parser, so the text handed out stays valid. argv[0]
+// is up to the caller, so any further name isn't kept, and neither the
+// cache nor the time the lock is held can grow without bound.
+struct parser_base::help_cache
 {
-  std::cerr << "Usage: ";
-  std::cerr << program;
-  std::cerr << " [OPTIONS]";
+  static constexpr std::size_t max_entries = 4;
+
+  struct entry
+  {
+    std::string program;
+    std::string help;
+    std::string usage;
+  };
+
+  std::mutex lock;
+  std::deque<entry> entries;
+
+  // nullptr if the name isn't cached and the cache is full
+  const entry* get(const parser_base& parser, std::string_view program)
+  {
+    const std::scoped_lock guard(lock);
+    for (const auto& crnt : entries) {
+      if (crnt.program == program) {
+        return &crnt;
+      }
+    }
+
+    if (std::size(entries) == max_entries) {
+      return nullptr;
+    }
+
+    auto& res = entries.emplace_back();
+    res.program = program;
+    parser.render_long(res.help, program);
+    parser.render_short(res.usage, program);
+    return &res;
+  }
+
+  // a parser that was moved from has no cache left
+  static const entry* find(const parser_base& parser, std::string_view program)
+  {
+    const auto& cache = parser.m_help;
+    return cache != nullptr ? cache->get(parser, program) : nullptr;
+  }
+};
+
+std::shared_ptr<parser_base::help_cache> parser_base::make_help_cache()
+{
+  return std::make_shared<help_cache>();
+}
+
+void parser_base::render_usage(std::string& out, std::string_view program)
+    const
+{
+  out += "Usage: ";
+  out += program;
+  out += " [OPTIONS]";
   for (const auto& pos : m_pos) {
-    std::cerr << std::format(" {}", pos.name());
+    out += ' ';
+    out += pos.name();
   }
   if (m_pos.is_list()) {
-    std::cerr << "...";
+    out += "...";
   }
-  std::cerr << '\n';
+  out += '\n';
 }
 
-bool parser_base::help_long(std::string_view program) const
+void parser_base::render_long(std::string& out, std::string_view program)
+    const
 {
-  help_usage(program);
+  render_usage(out, program);
 
   auto idx = size_type(0_u);
   for (const auto& [end_idx, name] : m_groups) {
-    std::cerr << std::format("\n{}:\n", name);
+    out += std::format("\n{}:\n", name);
     while (idx < end_idx) {
       const auto& opt = m_options[idx++];
-      std::string line;
+      const auto line_start = std::size(out);
 
-      line += " ";
+      out += " ";
       if (opt.has_opt_short()) {
-        line += std::format(" -{},", opt.opt_short());
+        out += std::format(" -{},", opt.opt_short());
       } else {
-        line += std::string(4, ' ');
+        out.append(4, ' ');
       }
       if (opt.has_opt_long()) {
-        line += " ";
-        line += format_option_long(opt);
+        out += " ";
+        format_option_long(out, opt);
       }
 
-      static constexpr const auto zero = std::size_t {0};
-      static constexpr const auto mid = std::size_t {30};
-      line += std::string(based::max(zero, mid - std::size(line)), ' ');
-
-      std::cerr << line << opt.message() << '\n';
+      pad(out, line_start);
+      out += opt.message();
+      out += '\n';
     }
   }
 
-  std::cerr << '\n';
-  return true;
+  out += '\n';
 }
 
-bool parser_base::help_short(std::string_view program) const
+void parser_base::render_short(std::string& out, std::string_view program)
+    const
 {
   std::vector<std::string> opts_short;
   std::vector<std::string> opts_long;
@@ -103,7 +201,7 @@ bool parser_base::help_short(std::string_view program) const
     }
 
     if (opt.has_opt_long()) {
-      opts_long.emplace_back(format_option_long(opt));
+      format_option_long(opts_long.emplace_back(), opt);
     }
   }
 
@@ -112,14 +210,16 @@ bool parser_base::help_short(std::string_view program) const
   std::ranges::sort(flags);
 
   static const std::string_view usage = "Usage:";
-  std::cerr << usage << ' ';
+  out += usage;
+  out += ' ';
 
   std::string line;
-  const auto print = [&line](std::string_view data)
+  const auto print = [&out, &line](std::string_view data)
   {
     static constexpr const auto lim = std::size_t {60};
     if (std::size(line) + std::size(data) > lim) {
-      std::cerr << line << '\n';
+      out += line;
+      out += '\n';
       line = std::string(std::size(usage), ' ');
     }
     line += " ";
@@ -143,12 +243,76 @@ bool parser_base::help_short(std::string_view program) const
     print(pos.name());
   }
 
-  std::cerr << line;
+  out += line;
   if (m_pos.is_list()) {
-    std::cerr << "...";
+    out += "...";
+  }
+  out += "\n\n";
+}
+
+// names that aren't cached are rendered into a buffer of the thread, which
+// stays valid until its next such text
+std::string_view parser_base::help_text(std::string_view program) const
+{
+  if (const auto* entry = help_cache::find(*this, program)) {
+    return entry->help;
+  }
+
+  thread_local std::string text;
+  text.clear();
+  render_long(text, program);
+  return text;
+}
+
+std::string_view parser_base::usage_text(std::string_view program) const
+{
+  if (const auto* entry = help_cache::find(*this, program)) {
+    return entry->usage;
   }
-  std::cerr << '\n' << '\n';
+
+  thread_local std::string text;
+  text.clear();
+  render_short(text, program);
+  return text;
+}
+
+bool parser_base::write_help(int fd, std::string_view program) const
+{
+  return write_all(fd, help_text(program));
+}
+
+bool parser_base::write_usage(int fd, std::string_view program) const
+{
+  return write_all(fd, usage_text(program));
+}
+
+bool parser_base::help_long(std::string_view program) const
+{
+  (void)write_help(stderr_fd, program);
+  return true;
+}
+
+bool parser_base::help_short(std::string_view program) const
+{
+  (void)write_usage(stderr_fd, program);
   return true;
 }
 
+void help_commands(
+    std::string_view program, std::span<const command_info> commands
+)
+{
+  std::string out = std::format("Usage: {} COMMAND [ARGS]...\n", program);
+  out += "\nCommands:\n";
+  for (const auto& cmd : commands) {
+    const auto line_start = std::size(out);
+    out += std::format("  {}", cmd.name);
+    pad(out, line_start);
+    out += cmd.message;
+    out += '\n';
+  }
+  out += '\n';
+  (void)write_all(stderr_fd, out);
+}
+
 }  // namespace poafloc::detail
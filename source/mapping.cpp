@@ -0,0 +1,74 @@
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <optional>
+
+#include "mapping.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#else
+#  include <fstream>
+#  include <iterator>
+#  include <string>
+#endif
+
+namespace poafloc::detail
+{
+
+#if defined(__unix__) || defined(__APPLE__)
+std::optional<mapping> map_file(const std::filesystem::path& path)
+{
+  const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);  // NOLINT
+  if (fd < 0) {
+    return {};
+  }
+
+  struct stat info = {};
+  if (::fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+    ::close(fd);
+    return {};
+  }
+
+  const auto size = static_cast<std::size_t>(info.st_size);
+  if (size == 0) {
+    ::close(fd);
+    return mapping {};
+  }
+
+  void* addr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (addr == MAP_FAILED) {  // NOLINT(*cast*)
+    return {};
+  }
+  ::madvise(addr, size, MADV_SEQUENTIAL);
+
+  const auto owner = std::shared_ptr<const char>(
+      static_cast<const char*>(addr),
+      [size](const char* ptr)
+      {
+        ::munmap(const_cast<char*>(ptr), size);  // NOLINT(*const-cast*)
+      }
+  );
+  return mapping {owner, {owner.get(), size}};
+}
+#else
+// no memory mapping here, the file is read in one go instead
+std::optional<mapping> map_file(const std::filesystem::path& path)
+{
+  std::ifstream ifs(path, std::ios::binary);
+  if (!ifs) {
+    return {};
+  }
+
+  const auto buffer = std::make_shared<const std::string>(
+      std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>()
+  );
+  return mapping {{buffer, buffer->data()}, *buffer};
+}
+#endif
+
+}  // namespace poafloc::detail
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string_view>
+
+namespace poafloc::detail
+{
+
+// contents of a file, kept alive by owner
+struct mapping
+{
+  std::shared_ptr<const char> owner;
+  std::string_view text;
+};
+
+// Memory maps a regular file where that is possible, and reads it in one go
+// elsewhere. Nothing is returned if the file can't be read.
+std::optional<mapping> map_file(const std::filesystem::path& path);
+
+}  // namespace poafloc::detail
@@ -1,9 +1,9 @@
 #include <algorithm>
+#include <bit>
+#include <numeric>
+#include <vector>
 
 #include <based/char/character.hpp>
-#include <based/char/is/alpha.hpp>
-#include <based/char/is/alpha_lower.hpp>
-#include <based/char/is/digit.hpp>
 #include <based/char/mapper.hpp>
 #include <based/functional/predicate/not_null.hpp>
 #include <based/trait/iterator.hpp>
@@ -14,24 +14,8 @@
 namespace
 {
 
-struct short_map
-{
-  constexpr bool operator()(based::character chr) const
-  {
-    return based::is_alpha(chr) || chr == '?';
-  }
-};
-
-struct long_map
-{
-  constexpr bool operator()(based::character chr) const
-  {
-    return based::is_alpha_lower(chr) || based::is_digit(chr);
-  }
-};
-
-using short_mapper = based::mapper<short_map>;
-using long_mapper = based::mapper<long_map>;
+using short_mapper = based::mapper<poafloc::detail::short_map>;
+using long_mapper = based::mapper<poafloc::detail::long_map>;
 
 }  // namespace
 
@@ -39,22 +23,14 @@ using long_mapper = based::mapper<long_map>;
 namespace poafloc::detail
 {
 
-constexpr bool option_short::is_valid(based::character chr)
-{
-  return short_mapper::predicate(chr);
-}
-
 bool option_short::has(based::character chr) const
 {
   return m_opts[short_mapper::map(chr)] != sentinel;
 }
 
+// names are validated by option_names
 bool option_short::set(based::character chr, value_type value)
 {
-  if (!is_valid(chr)) {
-    throw error<error_code::invalid_option>(chr);
-  }
-
   if (has(chr)) {
     return false;
   }
@@ -69,7 +45,12 @@ option_short::opt_type option_short::get(based::character chr) const
     throw error<error_code::invalid_option>(chr);
   }
 
-  if (!has(chr)) {
+  return find(chr);
+}
+
+option_short::opt_type option_short::find(based::character chr) const
+{
+  if (!is_valid(chr) || !has(chr)) {
     return {};
   }
 
@@ -82,45 +63,67 @@ option_short::opt_type option_short::get(based::character chr) const
 namespace poafloc::detail
 {
 
+trie_t::index_type trie_t::add_node()
+{
+  const auto offset = m_children.size();
+  m_children.resize(offset + index_type(size));
+  m_nodes.emplace_back();
+  return offset;
+}
+
+void trie_t::reserve(trie_t& trie, std::size_t keys_size)
+{
+  const auto nodes = keys_size + 1;
+  trie.m_children.reserve(index_type::underlying_cast(nodes * size));
+  trie.m_nodes.reserve(index_type::underlying_cast(nodes));
+}
+
 bool trie_t::set(trie_t& trie, std::string_view key, value_type value)
 {
-  trie_t* crnt = &trie;
+  auto crnt = index_type(0_u);
   for (const auto c : key) {
-    crnt->m_count++;
-    if (!crnt->m_terminal) {
-      crnt->m_value = value;
+    auto& node = trie.m_nodes[crnt / index_type(size)];
+
+    // only unique prefixes are resolved, so counting stops at two
+    if (node.count < 2_u8) {
+      node.count++;
+    }
+
+    if (!node.terminal) {
+      node.value = value;
     }
 
-    const auto idx = long_mapper::map(c);
-    if (crnt->m_children[idx] == nullptr) {
-      crnt->m_children[idx] = std::make_unique<trie_t>(nullptr);
+    const auto idx = crnt + long_mapper::map(c);
+    if (trie.m_children[idx] == index_type(0_u)) {
+      const auto child = trie.add_node();  // invalidates node
+      trie.m_children[idx] = child;
     }
-    crnt = crnt->m_children[idx].get();
+    crnt = trie.m_children[idx];
   }
 
-  if (crnt->m_terminal) {
+  auto& node = trie.m_nodes[crnt / index_type(size)];
+  if (node.terminal) {
     return false;
   }
 
-  crnt->m_value = value;
-  crnt->m_terminal = true;
+  node.value = value;
+  node.terminal = true;
   return true;
 }
 
 trie_t::opt_type trie_t::get(const trie_t& trie, std::string_view key)
 {
-  const trie_t* crnt = &trie;
-
+  auto crnt = index_type(0_u);
   for (const auto c : key) {
-    const auto idx = long_mapper::map(c);
-    if (crnt->m_children[idx] == nullptr) {
+    crnt = trie.m_children[crnt + long_mapper::map(c)];
+    if (crnt == index_type(0_u)) {
       return {};
     }
-    crnt = crnt->m_children[idx].get();
   }
 
-  if (crnt->m_terminal || crnt->m_count == 1_u8) {
-    return crnt->m_value;
+  const auto& node = trie.m_nodes[crnt / index_type(size)];
+  if (node.terminal || node.count == 1_u8) {
+    return node.value;
   }
 
   return {};
@@ -128,31 +131,158 @@ trie_t::opt_type trie_t::get(const trie_t& trie, std::string_view key)
 
 }  // namespace poafloc::detail
 
+// perfect_hash
+namespace poafloc::detail
+{
+
+void perfect_hash::reserve(std::size_t keys, std::size_t keys_size)
+{
+  m_pending.reserve(keys);
+  m_keys.reserve(keys_size);
+}
+
+void perfect_hash::insert(std::string_view key, value_type value)
+{
+  if (std::size(key) > max_key) {
+    return;
+  }
+
+  m_pending.push_back({
+      .offset = static_cast<std::uint32_t>(std::size(m_keys)),
+      .size = static_cast<std::uint16_t>(std::size(key)),
+      .value = value,
+  });
+  m_keys += key;
+}
+
+void perfect_hash::build()
+{
+  const auto count = std::size(m_pending);
+  if (count == 0) {
+    return;
+  }
+
+  // average bucket of four keys, table at most 80% full
+  static constexpr std::size_t bucket_size = 4;
+  static constexpr std::uint32_t max_seed = 1U << 16U;
+  const auto buckets = (count + bucket_size - 1) / bucket_size;
+  auto slots = std::bit_ceil(count + (count / 4) + 1);
+
+  std::vector<std::uint64_t> hashes;
+  std::vector<std::vector<std::size_t>> members(buckets);
+  hashes.reserve(count);
+  for (std::size_t i = 0; i < count; i++) {
+    hashes.push_back(hash(key(m_pending[i])));
+    members[reduce(hashes.back(), buckets)].push_back(i);
+  }
+
+  // place the biggest buckets first, while the table is still empty
+  std::vector<std::size_t> order(buckets);
+  std::iota(std::begin(order), std::end(order), 0);
+  std::ranges::stable_sort(
+      order,
+      [&](auto lhs, auto rhs)
+      { return std::size(members[lhs]) > std::size(members[rhs]); }
+  );
+
+  std::vector<std::uint64_t> taken;
+  const auto place = [&](const auto& bucket, std::uint32_t seed)
+  {
+    taken.clear();
+    for (const auto idx : bucket) {
+      const auto pos = mix(hashes[idx], seed) & m_mask;
+      if (m_slots[pos].size != 0
+          || std::ranges::find(taken, pos) != std::end(taken))
+      {
+        return false;
+      }
+      taken.push_back(pos);
+    }
+
+    for (std::size_t i = 0; i < std::size(bucket); i++) {
+      m_slots[taken[i]] = m_pending[bucket[i]];
+    }
+    return true;
+  };
+
+  while (true) {
+    m_slots.assign(slots, slot {});
+    m_seeds.assign(buckets, 0);
+    m_mask = slots - 1;
+
+    const bool placed = std::ranges::all_of(
+        order,
+        [&](auto bucket)
+        {
+          for (std::uint32_t seed = 0; seed < max_seed; seed++) {
+            if (place(members[bucket], seed)) {
+              m_seeds[bucket] = seed;
+              return true;
+            }
+          }
+          return false;
+        }
+    );
+
+    if (placed) {
+      break;
+    }
+
+    slots *= 2;
+  }
+
+  m_pending = {};
+}
+
+}  // namespace poafloc::detail
+
 // option_long
 namespace poafloc::detail
 {
 
-constexpr bool option_long::is_valid(std::string_view opt)
+void option_long::reserve(std::size_t opts, std::size_t opts_size)
 {
-  return based::is_alpha_lower(opt.front())
-      && std::ranges::all_of(opt, long_mapper::predicate);
+  trie_t::reserve(m_trie, opts_size);
+  m_exact.reserve(opts, opts_size);
 }
 
+// names are validated by option_names
 bool option_long::set(std::string_view opt, value_type idx)
 {
-  if (!is_valid(opt)) {
-    throw error<error_code::invalid_option>(opt);
+  if (!trie_t::set(m_trie, opt, idx)) {
+    return false;
   }
 
-  return trie_t::set(m_trie, opt, idx);
+  m_exact.insert(opt, idx);
+  return true;
+}
+
+void option_long::build()
+{
+  m_exact.build();
 }
 
 option_long::opt_type option_long::get(std::string_view opt) const
 {
-  if (!is_valid(opt)) {
+  const auto idx = find(opt);
+  if (!idx.has_value() && !is_valid(opt)) {
     throw error<error_code::invalid_option>(opt);
   }
 
+  return idx;
+}
+
+option_long::opt_type option_long::find(std::string_view opt) const
+{
+  // most options are spelled out in full, trie is needed for abbreviations
+  if (const auto idx = m_exact.get(opt); idx.has_value()) {
+    return idx;
+  }
+
+  if (!is_valid(opt)) {
+    return {};
+  }
+
   return trie_t::get(m_trie, opt);
 }
 
@@ -5,14 +5,88 @@
 namespace
 {
 
-constexpr bool is_option_str(std::string_view arg)
+using poafloc::error_code;
+using poafloc::parse_error;
+using poafloc::detail::action;
+using poafloc::detail::option;
+
+// an option that can't be found is either misspelled or not a valid name
+parse_error not_found(bool valid, std::size_t idx, std::string_view opt)
+{
+  return {
+      valid ? error_code::unknown_option : error_code::invalid_option,
+      idx,
+      opt,
+  };
+}
+
+// for the actions of options, and the positional arguments
+template<class Option>
+std::optional<parse_error> apply(
+    const Option& option, void* record, std::size_t idx, std::string_view value
+)
+{
+  const auto err = option(record, value);
+  if (err == std::errc {}) {
+    return {};
+  }
+
+  return parse_error {
+      err == std::errc::result_out_of_range ? error_code::out_of_range
+                                            : error_code::invalid_argument,
+      idx,
+      value,
+  };
+}
+
+bool is_dashed(const char* arg)
 {
-  return arg.starts_with("-");
+  return *arg == '-';
 }
 
-constexpr bool is_next_option(std::span<const std::string_view> args)
+bool is_dashed(std::string_view arg)
 {
-  return args.empty() || is_option_str(args.front());
+  return arg.starts_with('-');
+}
+
+bool is_blank(char chr)
+{
+  return chr == ' ' || chr == '\t' || chr == '\r';
+}
+
+std::string_view trim(std::string_view str)
+{
+  while (!str.empty() && is_blank(str.front())) {
+    str.remove_prefix(1);
+  }
+  while (!str.empty() && is_blank(str.back())) {
+    str.remove_suffix(1);
+  }
+  return str;
+}
+
+std::string_view unquote(std::string_view value)
+{
+  if (std::size(value) > 1 && value.front() == '"' && value.back() == '"') {
+    return value.substr(1, std::size(value) - 2);
+  }
+  return value;
+}
+
+// nothing for a value that is neither
+std::optional<bool> to_bool(std::string_view value)
+{
+  for (const std::string_view yes : {"true", "yes", "on", "1"}) {
+    if (value == yes) {
+      return true;
+    }
+  }
+  for (const std::string_view no : {"false", "no", "off", "0"}) {
+    if (value == no) {
+      return false;
+    }
+  }
+  return {};
 }
 
 }  // namespace
@@ -20,274 +94,652 @@ constexpr bool is_next_option(std::span<const std::string_view> args)
 namespace poafloc::detail
 {
 
-option::option(option::type opt_type, func_type func, std::string_view help)
+option::option(option::type opt_type, setter func, text help)
     : m_type(opt_type)
-    , m_func(std::move(func))
-    , m_name(help)
+    , m_func(func)
+    , m_literal_help(help.is_literal())
+    , m_name(help.view())
 {
 }
 
 option::option(
-    option::type opt_type,
-    std::string_view opts,
-    func_type func,
-    std::string_view help
+    option::type opt_type, option_names opts, setter func, text help
 )
     : m_type(opt_type)
-    , m_func(std::move(func))
+    , m_func(func)
+    , m_opt_short(opts.opt_short())
+    , m_literal_names(opts.is_literal())
+    , m_literal_help(help.is_literal())
+    , m_opt_long(opts.opt_long())
+    , m_env(opts.env())
 {
-  auto istr = std::istringstream(std::string(opts));
-  std::string str;
-
-  while (std::getline(istr, str, ' ')) {
-    if (std::size(str) == 1) {
-      m_opt_short = str[0];
-    } else {
-      m_opt_long = str;
-    }
+  const auto view = help.view();
+  if (opt_type != option::type::boolean) {
+    const auto pos = view.find(' ');
+    m_name = view.substr(0, pos);
+    m_message = view.substr(pos + 1);
+  } else {
+    m_message = view;
   }
+}
 
-  if (!has_opt_short() && !has_opt_long()) {
-    throw error<error_code::missing_option>();
+std::size_t option::arena_size() const
+{
+  std::size_t res = 0;
+  if (!m_literal_names) {
+    res += std::size(m_opt_long) + std::size(m_env);
   }
-
-  if (opt_type != option::type::boolean) {
-    const auto pos = help.find(' ');
-    m_name = help.substr(0, pos);
-    m_message = help.substr(pos + 1);
-  } else {
-    m_message = help;
+  if (!m_literal_help) {
+    res += std::size(m_name) + std::size(m_message);
   }
+  return res;
+}
+
+void option::intern(string_arena& arena)
+{
+  m_opt_long = arena.intern(m_opt_long, m_literal_names);
+  m_env = arena.intern(m_env, m_literal_names);
+  m_name = arena.intern(m_name, m_literal_help);
+  m_message = arena.intern(m_message, m_literal_help);
 }
 
 void parser_base::process(const option& option)
 {
+  // the largest index is the sentinel of the lookup tables
+  const auto count = std::size(m_options);
+  if (count >= size_type(based::limits<option_index>::max)) {
+    throw runtime_error("poafloc: too many options");
+  }
+  const auto idx = option_index::underlying_cast(count);
+
   if (option.has_opt_short()) {
     const auto& opt_short = option.opt_short();
-    if (!m_opt_short.set(opt_short, std::size(m_options))) {
+    if (!m_opt_short.set(opt_short, idx)) {
       throw error<error_code::duplicate_option>(opt_short);
     }
   }
 
   if (option.has_opt_long()) {
-    const auto& opt_long = option.opt_long();
-    if (!m_opt_long.set(opt_long, std::size(m_options))) {
+    const auto opt_long = option.opt_long();
+    if (!m_opt_long.set(opt_long, idx)) {
       throw error<error_code::duplicate_option>(opt_long);
     }
   }
 
+  m_actions.push_back({option.get_setter(), option.get_type()});
   m_options.emplace_back(option);
+  m_options.back().intern(m_arena);
 }
 
-void parser_base::operator()(void* record, int argc, const char** argv)
+// values following an option and the positional arguments are the bulk of
+// a long command line, everything else is left to hdl_argument
+template<bool Observe>
+parser_base::status parser_base::feed(state& crnt, std::string_view arg) const
 {
-  std::vector<std::string_view> args(
-      argv, argv + argc  // NOLINT(*pointer*)
-  );
-  operator()(record, args);
-}
+  const auto idx = crnt.index++;
+  instrument(crnt, [](auto& stats) { stats.arguments++; });
 
-void parser_base::operator()(
-    void* record, std::span<const std::string_view> args
-)
-{
-  if (args.empty()) {
-    throw error<error_code::empty>();
+  if (crnt.pending != nullptr && !arg.starts_with("-")) {
+    const auto& option = *crnt.pending;
+    if (option.get_type() == option::type::list) {
+      crnt.pending_taken = true;
+    } else {
+      crnt.pending = nullptr;
+    }
+    instrument(crnt, [](auto& stats) { stats.values++; });
+    notify<Observe>(
+        crnt,
+        [&]
+        {
+          return parse_event {
+              .kind = event_kind::value,
+              .index = idx,
+              .option = index_of(option),
+              .token = crnt.pending_opt,
+              .value = arg,
+          };
+        }
+    );
+    return convert(crnt, option, idx, arg);
   }
 
-  const auto program = args[0];
-  std::size_t arg_idx = 1;
-  bool is_term = false;
+  if (crnt.is_positional) {
+    return hdl_positional<Observe>(crnt, idx, arg);
+  }
 
-  while (arg_idx != std::size(args)) {
-    const auto arg_raw = args[arg_idx];
+  return hdl_argument<Observe>(crnt, idx, arg);
+}
 
-    if (!is_option_str(arg_raw)) {
-      break;
+template<bool Observe>
+parser_base::status parser_base::hdl_argument(
+    state& crnt, std::size_t idx, std::string_view arg
+) const
+{
+  if (idx == 0) {
+    crnt.program = arg;
+    if (!m_env.empty()) {
+      crnt.seen.resize(std::size(m_options).value);
     }
+    return {};
+  }
 
-    if (std::size(arg_raw) == 1) {
-      throw error<error_code::unknown_option>("-");
+  if (crnt.pending != nullptr) {
+    if (!crnt.pending_taken) {
+      return parse_error {
+          error_code::missing_argument, crnt.pending_index, crnt.pending_opt
+      };
     }
 
-    if (arg_raw == "--") {
-      is_term = true;
-      ++arg_idx;
-      break;
-    }
+    crnt.pending = nullptr;
+  }
 
-    const auto next = args.subspan(arg_idx + 1);
-    const auto res = arg_raw[1] != '-'
-        ? hdl_short_opts(program, record, arg_raw.substr(1), next)
-        : hdl_long_opt(program, record, arg_raw.substr(2), next);
-    arg_idx = std::size(args) - std::size(res);
+  const auto cls = classify(arg);
+  switch (cls.type) {
+    case arg_type::positional:
+      crnt.is_positional = true;
+      return hdl_positional<Observe>(crnt, idx, arg);
+    case arg_type::dash:
+      return parse_error {error_code::unknown_option, idx, arg};
+    case arg_type::terminator:
+      crnt.is_positional = crnt.is_term = true;
+      notify<Observe>(
+          crnt,
+          [&]
+          {
+            return parse_event {
+                .kind = event_kind::terminator, .index = idx, .token = arg
+            };
+          }
+      );
+      return {};
+    case arg_type::short_opts:
+      return hdl_short_opts<Observe>(crnt, idx, arg);
+    case arg_type::long_opt:
+      return hdl_long_opt<Observe>(crnt, idx, arg, cls.equal);
   }
 
-  size_type count = 0_u;
-  while (arg_idx != std::size(args)) {
-    const auto arg = args[arg_idx++];
-    if (!is_term && arg == "--") {
-      throw error<error_code::invalid_terminal>(arg);
-    }
+  return {};
+}
 
-    if (!is_term && is_option_str(arg)) {
-      throw error<error_code::invalid_positional>(arg);
-    }
+template<bool Observe>
+parser_base::status parser_base::finish(const state& crnt) const
+{
+  if (crnt.index == 0) {
+    return parse_error {error_code::empty, 0, {}};
+  }
 
-    if (!m_pos.is_list() && count == std::size(m_pos)) {
-      throw error<error_code::superfluous_positional>(std::size(m_pos));
-    }
+  notify<Observe>(
+      crnt,
+      [&] { return parse_event {.kind = event_kind::end, .index = crnt.index}; }
+  );
 
-    if (count == std::size(m_pos)) {
-      count--;
-    }
+  if (crnt.pending != nullptr && !crnt.pending_taken) {
+    return parse_error {
+        error_code::missing_argument, crnt.pending_index, crnt.pending_opt
+    };
+  }
 
-    m_pos[count++](record, arg);
+  if (crnt.count < std::size(m_pos)) {
+    return parse_error {error_code::missing_positional, crnt.index, {}};
   }
 
-  if (count < std::size(m_pos)) {
-    throw error<error_code::missing_positional>(std::size(m_pos));
+  if (!m_env.empty()) {
+    return apply_env(crnt);
   }
+
+  return {};
 }
 
-parser_base::next_t parser_base::hdl_short_opt(
-    void* record, based::character opt, std::string_view rest, next_t next
+template<class T>
+parser_base::status parser_base::parse_array(
+    void* record, std::span<const T> args
 ) const
 {
-  const auto option = get_option(opt);
+  state crnt {.record = record};
+  for (std::size_t i = 0; i < std::size(args); i++) {
+    if (auto res = feed(crnt, std::string_view(args[i]))) {
+      return report(crnt, res);
+    }
+    if (crnt.run != nullptr) {
+      reserve_run(crnt, args.subspan(i + 1));
+    }
+  }
+  return report(crnt, finish(crnt));
+}
+
+// Values of an option's list are the arguments up to the next option, a
+// positional list takes all of them. Only the first character is looked
+// at, so a C string isn't measured twice.
+template<class T>
+void parser_base::reserve_run(state& crnt, std::span<const T> rest)
+{
+  const auto* list = std::exchange(crnt.run, nullptr);
+  if (!list->can_reserve()) {
+    return;
+  }
 
-  if (!rest.empty()) {
-    if (rest.front() != '=') {
-      option(record, rest);
-      return next;
+  std::size_t count = std::size(rest);
+  if (crnt.pending != nullptr) {
+    count = 0;
+    while (count < std::size(rest) && !is_dashed(rest[count])) {
+      count++;
     }
+  }
+  list->reserve(crnt.record, count);
+}
 
-    const auto value = rest.substr(1);
-    if (!value.empty()) {
-      option(record, value);
-      return next;
+template parser_base::status parser_base::parse_array(
+    void*, std::span<const char* const>
+) const;
+template parser_base::status parser_base::parse_array(
+    void*, std::span<const std::string_view>
+) const;
+template parser_base::status parser_base::parse_array(
+    void*, std::span<const std::string>
+) const;
+
+template<bool Observe>
+parser_base::status parser_base::hdl_positional(
+    state& crnt, std::size_t idx, std::string_view arg
+) const
+{
+  if (!crnt.is_term) {
+    const auto type = classify_type(arg);
+    if (type == arg_type::terminator) {
+      return parse_error {error_code::invalid_terminal, idx, arg};
     }
 
-    throw error<error_code::missing_argument>(opt);
+    if (type != arg_type::positional) {
+      return parse_error {error_code::invalid_positional, idx, arg};
+    }
   }
 
-  if (is_next_option(next)) {
-    throw error<error_code::missing_argument>(opt);
+  if (!m_pos.is_list() && crnt.count == std::size(m_pos)) {
+    return parse_error {error_code::superfluous_positional, idx, arg};
   }
 
-  if (option.get_type() != option::type::list) {
-    option(record, next.front());
-    return next.subspan(1);
+  if (crnt.count == std::size(m_pos)) {
+    crnt.count--;
+  } else if (m_pos.is_list() && crnt.count + size_type(1_u) == std::size(m_pos))
+  {
+    crnt.run = &m_pos[crnt.count];  // the list takes all that is left
   }
 
-  while (!is_next_option(next)) {
-    option(record, next.front());
-    next = next.subspan(1);
-  }
+  notify<Observe>(
+      crnt,
+      [&]
+      {
+        return parse_event {
+            .kind = event_kind::positional,
+            .index = idx,
+            .option = crnt.count.value,
+            .value = arg,
+        };
+      }
+  );
+  return in_phase(
+      crnt,
+      &parse_stats::positional,
+      [&] { return apply(m_pos[crnt.count++], crnt.record, idx, arg); }
+  );
+}
 
-  return next;
+void parser_base::raise(const parse_error& err) const
+{
+  const auto token = err.token;
+  switch (err.code()) {
+    case error_code::help():
+      throw error<error_code::help>();
+    case error_code::empty():
+      throw error<error_code::empty>();
+    case error_code::invalid_option():
+      throw error<error_code::invalid_option>(token);
+    case error_code::invalid_positional():
+      throw error<error_code::invalid_positional>(token);
+    case error_code::invalid_terminal():
+      throw error<error_code::invalid_terminal>(token);
+    case error_code::missing_argument():
+      throw error<error_code::missing_argument>(token);
+    case error_code::missing_positional():
+      throw error<error_code::missing_positional>(std::size(m_pos));
+    case error_code::superfluous_argument():
+      throw error<error_code::superfluous_argument>(token);
+    case error_code::superfluous_positional():
+      throw error<error_code::superfluous_positional>(std::size(m_pos));
+    case error_code::unknown_option():
+      throw error<error_code::unknown_option>(token);
+    case error_code::invalid_argument():
+      throw error<error_code::invalid_argument>(token);
+    case error_code::out_of_range():
+      throw error<error_code::out_of_range>(token);
+    case error_code::invalid_environment():
+      throw error<error_code::invalid_environment>(token);
+    case error_code::invalid_config():
+      throw error<error_code::invalid_config>(token);
+    case error_code::unknown_section():
+      throw error<error_code::unknown_section>(token);
+    default:
+      throw runtime_error(error_get_message(err.code));
+  }
 }
 
-parser_base::next_t parser_base::hdl_short_opts(
-    std::string_view program, void* record, std::string_view arg, next_t next
+// value of an option is either the rest of the argument or the next one
+template<bool Observe>
+parser_base::status parser_base::hdl_short_opts(
+    state& crnt, std::size_t idx, std::string_view arg
 ) const
 {
-  std::size_t opt_idx = 0;
-  while (opt_idx < std::size(arg)) {
-    const auto opt = arg[opt_idx];
+  instrument(crnt, [](auto& stats) { stats.short_clusters++; });
+  for (std::size_t pos = 1; pos < std::size(arg); pos++) {
+    const auto opt = arg[pos];
+    const auto observe = [&](const action& option, std::string_view value)
+    {
+      notify<Observe>(
+          crnt,
+          [&]
+          {
+            return parse_event {
+                .kind = event_kind::short_option,
+                .index = idx,
+                .option = index_of(option),
+                .token = arg.substr(pos, 1),
+                .value = value,
+            };
+          }
+      );
+    };
 
     if (opt == '?') {
-      (void)help_long(program);
-      throw error<error_code::help>();
+      (void)help_long(crnt.program);
+      return parse_error {error_code::help, idx, arg.substr(pos, 1)};
     }
 
-    const auto option = get_option(opt);
-    if (option.get_type() != option::type::boolean) {
-      break;
+    const auto* option = lookup(crnt, opt);
+    if (option == nullptr) {
+      return not_found(option_short::is_valid(opt), idx, arg.substr(pos, 1));
     }
 
-    option(record, program);
-    opt_idx++;
+    mark_seen(crnt, *option);
+    if (option->get_type() == option::type::boolean) {
+      observe(*option, {});
+      if (auto res = convert(crnt, *option, idx, crnt.program)) {
+        return res;
+      }
+      continue;
+    }
+
+    const auto rest = arg.substr(pos + 1);
+    if (rest.empty()) {
+      observe(*option, {});
+      start_pending(crnt, *option, arg.substr(pos, 1), idx);
+      return {};
+    }
+
+    const auto value = rest.front() != '=' ? rest : rest.substr(1);
+    if (value.empty()) {
+      return parse_error {
+          error_code::missing_argument, idx, arg.substr(pos, 1)
+      };
+    }
+
+    observe(*option, value);
+    return convert(crnt, *option, idx, value);
   }
 
-  return opt_idx == std::size(arg)
-      ? next
-      : hdl_short_opt(record, arg[opt_idx], arg.substr(opt_idx + 1), next);
+  return {};
 }
 
-parser_base::next_t parser_base::hdl_long_opt(
-    std::string_view program, void* record, std::string_view arg, next_t next
+template<bool Observe>
+parser_base::status parser_base::hdl_long_opt(
+    state& crnt, std::size_t idx, std::string_view arg, std::size_t equal
 ) const
 {
-  const auto equal = arg.find('=');
-  if (equal != std::string::npos) {
-    auto opt = arg.substr(0, equal);
+  const auto observe =
+      [&](const action& option, std::string_view opt, std::string_view value)
+  {
+    notify<Observe>(
+        crnt,
+        [&]
+        {
+          return parse_event {
+              .kind = event_kind::long_option,
+              .index = idx,
+              .option = index_of(option),
+              .abbreviated = is_abbreviation(option, opt),
+              .token = opt,
+              .value = value,
+          };
+        }
+    );
+  };
+
+  if (equal != std::string_view::npos) {
+    instrument(crnt, [](auto& stats) { stats.long_values++; });
+    const auto opt = arg.substr(2, equal - 2);
     const auto value = arg.substr(equal + 1);
 
-    const auto option = get_option(opt);
-    if (option.get_type() == option::type::boolean) {
-      throw error<error_code::superfluous_argument>(opt);
+    const auto* option = lookup(crnt, opt);
+    if (option == nullptr) {
+      return not_found(option_long::is_valid(opt), idx, opt);
     }
 
-    if (!value.empty()) {
-      option(record, value);
-      return next;
+    if (option->get_type() == option::type::boolean) {
+      return parse_error {error_code::superfluous_argument, idx, opt};
     }
 
-    throw error<error_code::missing_argument>(opt);
+    if (value.empty()) {
+      return parse_error {error_code::missing_argument, idx, opt};
+    }
+
+    mark_seen(crnt, *option);
+    observe(*option, opt, value);
+    return convert(crnt, *option, idx, value);
   }
 
-  const auto opt = arg;
+  instrument(crnt, [](auto& stats) { stats.long_options++; });
+  const auto opt = arg.substr(2);
 
   if (opt == "help") {
-    (void)help_long(program);
-    throw error<error_code::help>();
+    (void)help_long(crnt.program);
+    return parse_error {error_code::help, idx, opt};
   }
 
   if (opt == "usage") {
-    (void)help_short(program);
-    throw error<error_code::help>();
+    (void)help_short(crnt.program);
+    return parse_error {error_code::help, idx, opt};
   }
 
-  const auto option = get_option(opt);
-  if (option.get_type() == option::type::boolean) {
-    option(record, program);
-    return next;
+  const auto* option = lookup(crnt, opt);
+  if (option == nullptr) {
+    return not_found(option_long::is_valid(opt), idx, opt);
   }
 
-  if (is_next_option(next)) {
-    throw error<error_code::missing_argument>(opt);
+  mark_seen(crnt, *option);
+  observe(*option, opt, {});
+  if (option->get_type() == option::type::boolean) {
+    return convert(crnt, *option, idx, crnt.program);
   }
 
-  if (option.get_type() != option::type::list) {
-    option(record, next.front());
-    return next.subspan(1);
-  }
+  start_pending(crnt, *option, opt, idx);
+  return {};
+}
+
+// Lines are views into text, one pass and no copies. Keys outside of any
+// section may name any option, the informational ones excluded.
+parser_base::status parser_base::load(void* record, std::string_view text)
+    const
+{
+  auto begin = size_type(0_u);
+  auto end = informational_begin();
+
+  std::size_t line_no = 0;
+  while (!text.empty()) {
+    line_no++;
+    const auto eol = text.find('\n');
+    const auto line = trim(text.substr(0, eol));
+    text = eol == std::string_view::npos ? "" : text.substr(eol + 1);
+
+    if (line.empty() || line.front() == '#' || line.front() == ';') {
+      continue;
+    }
+
+    if (line.front() == '[') {
+      if (line.back() != ']') {
+        return parse_error {error_code::invalid_config, line_no, line};
+      }
+
+      const auto name = trim(line.substr(1, std::size(line) - 2));
+      const auto last = informational_begin();
+      auto start = size_type(0_u);
+      bool found = false;
+      for (const auto& [group_end, group_name] : m_groups) {
+        if (group_end > last) {
+          break;
+        }
+        if (group_name == name) {
+          begin = start;
+          end = group_end;
+          found = true;
+          break;
+        }
+        start = group_end;
+      }
+
+      if (!found) {
+        return parse_error {error_code::unknown_section, line_no, name};
+      }
+      continue;
+    }
 
-  while (!is_next_option(next)) {
-    option(record, next.front());
-    next = next.subspan(1);
+    const auto equal = line.find('=');
+    const auto key = trim(line.substr(0, equal));
+    const auto value = equal == std::string_view::npos
+        ? std::string_view {}
+        : unquote(trim(line.substr(equal + 1)));
+
+    const auto* option = get_option(key);
+    if (option == nullptr) {
+      return not_found(option_long::is_valid(key), line_no, key);
+    }
+
+    const auto pos = size_type::underlying_cast(index_of(*option));
+    if (pos < begin || pos >= end) {
+      return parse_error {error_code::unknown_option, line_no, key};
+    }
+
+    if (option->get_type() == option::type::boolean) {
+      const auto enable =
+          equal == std::string_view::npos ? true : to_bool(value);
+      if (!enable.has_value()) {
+        return parse_error {error_code::invalid_argument, line_no, value};
+      }
+      if (*enable) {
+        (void)(*option)(record, key);
+      }
+      continue;
+    }
+
+    if (value.empty()) {
+      return parse_error {error_code::missing_argument, line_no, key};
+    }
+
+    if (auto res = apply(*option, record, line_no, value)) {
+      return res;
+    }
   }
 
-  return next;
+  return {};
 }
 
-[[nodiscard]] const option& parser_base::get_option(based::character opt) const
+[[nodiscard]] const action* parser_base::get_option(based::character opt) const
 {
-  const auto idx = m_opt_short.get(opt);
-  if (!idx.has_value()) {
-    throw error<error_code::unknown_option>(opt);
-  }
-  return m_options[idx.value()];
+  const auto idx = m_opt_short.find(opt);
+  return idx.has_value() ? &m_actions[size_type(idx.value())] : nullptr;
+}
+
+[[nodiscard]] const action* parser_base::get_option(std::string_view opt) const
+{
+  const auto idx = m_opt_long.find(opt);
+  return idx.has_value() ? &m_actions[size_type(idx.value())] : nullptr;
 }
 
-[[nodiscard]] const option& parser_base::get_option(std::string_view opt) const
+void parser_base::start_pending(
+    state& crnt, const action& option, std::string_view opt, std::size_t idx
+) const
 {
-  const auto idx = m_opt_long.get(opt);
-  if (!idx.has_value()) {
-    throw error<error_code::unknown_option>(opt);
+  crnt.pending = &option;
+  crnt.pending_opt = opt;
+  crnt.pending_index = idx;
+  crnt.pending_taken = false;
+  if (option.get_type() == option::type::list) {
+    crnt.run = &m_options[size_type::underlying_cast(index_of(option))];
   }
-  return m_options[idx.value()];
 }
 
+std::size_t parser_base::index_of(const action& option) const
+{
+  return static_cast<std::size_t>(&option - &m_actions[size_type(0_u)]);
+}
+
+bool parser_base::is_abbreviation(const action& option, std::string_view opt)
+    const
+{
+  const auto idx = size_type::underlying_cast(index_of(option));
+  return std::size(m_options[idx].opt_long()) != std::size(opt);
+}
+
+const action* parser_base::lookup(state& crnt, based::character opt) const
+{
+  return in_phase(crnt, &parse_stats::lookup, [&] { return get_option(opt); });
+}
+
+const action* parser_base::lookup(state& crnt, std::string_view opt) const
+{
+  const auto* res =
+      in_phase(crnt, &parse_stats::lookup, [&] { return get_option(opt); });
+
+  instrument(
+      crnt,
+      [&](auto& stats)
+      {
+        if (res != nullptr && is_abbreviation(*res, opt)) {
+          stats.abbreviations++;
+        }
+      }
+  );
+  return res;
+}
+
+parser_base::status parser_base::convert(
+    state& crnt, const action& option, std::size_t idx, std::string_view value
+)
+{
+  return in_phase(
+      crnt,
+      &parse_stats::conversion,
+      [&] { return apply(option, crnt.record, idx, value); }
+  );
+}
+
+// the parser as used from the header, for parse_session and for observed
+// parses
+template parser_base::status parser_base::feed<false>(
+    state&, std::string_view
+) const;
+template parser_base::status parser_base::feed<true>(
+    state&, std::string_view
+) const;
+
+template parser_base::status parser_base::finish<false>(const state&) const;
+template parser_base::status parser_base::finish<true>(const state&) const;
+
+// instantiated as a whole, not only inlined into feed, which is then kept
+// small enough to be inlined into parse_array
+template parser_base::status parser_base::hdl_argument<false>(
+    state&, std::size_t, std::string_view
+) const;
+template parser_base::status parser_base::hdl_argument<true>(
+    state&, std::size_t, std::string_view
+) const;
+
 }  // namespace poafloc::detail
@@ -0,0 +1,136 @@
+#include <algorithm>
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include "poafloc/response.hpp"
+
+#include "mapping.hpp"
+#include "poafloc/error.hpp"
+#include "poafloc/tokenizer.hpp"
+
+namespace
+{
+
+bool is_response(std::string_view arg)
+{
+  return std::size(arg) > 1 && arg.front() == '@';
+}
+
+}  // namespace
+
+namespace poafloc
+{
+
+// the words of the file are put at the end, the ones from the first nested
+// @file on are set aside in a frame, to be spliced in after it
+void response_files::splice(std::string_view arg, std::vector<frame>& open)
+{
+  if (!is_response(arg)) {
+    m_args.push_back(arg);
+    return;
+  }
+
+  const auto name = arg.substr(1);
+
+  std::error_code err;
+  const auto path = std::filesystem::canonical(name, err);
+  if (err) {
+    m_args.push_back(arg);
+    return;
+  }
+
+  auto ident = path.string();
+  if (std::ranges::any_of(
+          open, [&](const frame& frm) { return frm.ident == ident; }
+      ))
+  {
+    throw error<error_code::recursive_response>(name);
+  }
+
+  auto file = detail::map_file(path);
+  if (!file.has_value()) {
+    m_args.push_back(arg);
+    return;
+  }
+  m_files.push_back(std::move(file->owner));
+
+  const auto first = static_cast<std::ptrdiff_t>(std::size(m_args));
+  detail::split_words(file->text, m_scratch.emplace_back(), m_args);
+
+  const auto nested =
+      std::find_if(m_args.begin() + first, m_args.end(), is_response);
+  if (nested == m_args.end()) {
+    return;
+  }
+
+  open.push_back({
+      .ident = std::move(ident),
+      .rest = std::vector<std::string_view>(nested, m_args.end()),
+  });
+  m_args.erase(nested, m_args.end());
+}
+
+// open holds the files being expanded, outermost first. The words after a
+// nested @file are set aside once per file and taken back as its nested
+// files are done, so expanding stays linear in the number of words however
+// many files are nested
+void response_files::add(std::string_view arg, std::vector<frame>& open)
+{
+  splice(arg, open);
+  while (!open.empty()) {
+    auto& top = open.back();
+    const auto begin =
+        top.rest.begin() + static_cast<std::ptrdiff_t>(top.next);
+    const auto nested = std::find_if(begin, top.rest.end(), is_response);
+    m_args.insert(m_args.end(), begin, nested);
+    if (nested == top.rest.end()) {
+      open.pop_back();
+      continue;
+    }
+
+    top.next = static_cast<std::size_t>(nested - top.rest.begin()) + 1;
+    splice(*nested, open);
+  }
+}
+
+template<class Range>
+std::span<const std::string_view> response_files::expand_range(
+    const Range& args
+)
+{
+  m_files.clear();
+  m_scratch.clear();
+  m_args.clear();
+
+  std::vector<frame> open;
+  for (const auto& arg : args) {
+    // the program name is never expanded
+    if (m_args.empty()) {
+      m_args.emplace_back(arg);
+      continue;
+    }
+    add(arg, open);
+  }
+
+  return m_args;
+}
+
+std::span<const std::string_view> response_files::expand(
+    int argc, const char* const* argv
+)
+{
+  return expand_range(std::span(argv, static_cast<std::size_t>(argc)));
+}
+
+std::span<const std::string_view> response_files::expand(
+    std::span<const std::string_view> args
+)
+{
+  return expand_range(args);
+}
+
+}  // namespace poafloc
@@ -0,0 +1,93 @@
+#include <memory>
+#include <mutex>
+#include <utility>
+
+#include "poafloc/stats.hpp"
+
+#include "poafloc/poafloc.hpp"
+
+namespace poafloc
+{
+
+parse_stats::phase& parse_stats::phase::operator+=(const phase& rhs)
+{
+  count += rhs.count;
+  time += rhs.time;
+  return *this;
+}
+
+parse_stats& parse_stats::operator+=(const parse_stats& rhs)
+{
+  parses += rhs.parses;
+  arguments += rhs.arguments;
+  short_clusters += rhs.short_clusters;
+  long_options += rhs.long_options;
+  long_values += rhs.long_values;
+  values += rhs.values;
+  abbreviations += rhs.abbreviations;
+  lookup += rhs.lookup;
+  conversion += rhs.conversion;
+  positional += rhs.positional;
+  for (std::size_t i = 0; i < error_code_count; i++) {
+    errors[i] += rhs.errors[i];
+  }
+  return *this;
+}
+
+}  // namespace poafloc
+
+namespace poafloc::detail
+{
+
+// a parse is added once it's done, so the lock is taken once per parse
+struct parser_base::stats_sink
+{
+  std::mutex lock;
+  parse_stats totals;
+};
+
+std::shared_ptr<parser_base::stats_sink> parser_base::make_stats_sink()
+{
+  if constexpr (instrumented) {
+    return std::make_shared<stats_sink>();
+  } else {
+    return nullptr;
+  }
+}
+
+void parser_base::collect(const parse_stats& stats, const status& res) const
+{
+  if (m_stats == nullptr) {
+    return;
+  }
+
+  const std::scoped_lock guard(m_stats->lock);
+  auto& totals = m_stats->totals;
+  totals += stats;
+  totals.parses++;
+  if (res.has_value()) {
+    totals.errors[static_cast<std::size_t>(res->code())]++;
+  }
+}
+
+parse_stats parser_base::stats() const
+{
+  if (m_stats == nullptr) {
+    return {};
+  }
+
+  const std::scoped_lock guard(m_stats->lock);
+  return m_stats->totals;
+}
+
+parse_stats parser_base::take_stats() const
+{
+  if (m_stats == nullptr) {
+    return {};
+  }
+
+  const std::scoped_lock guard(m_stats->lock);
+  return std::exchange(m_stats->totals, {});
+}
+
+}  // namespace poafloc::detail
@@ -0,0 +1,210 @@
+#include <array>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#include "poafloc/tokenizer.hpp"
+
+#include "poafloc/error.hpp"
+
+namespace
+{
+
+using poafloc::error;
+using poafloc::error_code;
+
+constexpr auto npos = std::string_view::npos;
+
+constexpr bool is_blank(char chr)
+{
+  return chr == ' ' || chr == '\t' || chr == '\n';
+}
+
+// characters that end a run of literal characters outside of quotes, looked
+// up in a table as the run is scanned one character at a time
+constexpr auto specials = []
+{
+  std::array<bool, 256> res = {};  // NOLINT(*magic*)
+  for (const auto chr : std::string_view(" \t\n'\"\\")) {
+    res[static_cast<unsigned char>(chr)] = true;
+  }
+  return res;
+}();
+
+constexpr bool is_special(char chr)
+{
+  return specials[static_cast<unsigned char>(chr)];
+}
+
+// the only characters a backslash escapes inside double quotes
+constexpr bool is_dquote_escape(char chr)
+{
+  return chr == '$' || chr == '`' || chr == '"' || chr == '\\' || chr == '\n';
+}
+
+// Word being put together: a view into the line for as long as its pieces
+// follow each other there, copied to the scratch buffer from the first gap
+class word_builder
+{
+  std::string& m_scratch;
+  const char* m_end;  // of the line
+  std::string_view m_view;
+  std::size_t m_offset = npos;  // into the scratch buffer, once copied
+
+public:
+  word_builder(std::string& scratch, std::string_view line)
+      : m_scratch(scratch)
+      , m_end(line.data() + line.size())
+  {
+  }
+
+  void append(std::string_view piece)
+  {
+    if (piece.empty()) {
+      return;
+    }
+
+    if (m_offset == npos) {
+      if (m_view.empty()) {
+        m_view = piece;
+        return;
+      }
+
+      if (m_view.data() + m_view.size() == piece.data()) {
+        m_view = {m_view.data(), m_view.size() + piece.size()};
+        return;
+      }
+
+      // unquoting never makes the rest of the line longer, so the buffer is
+      // never reallocated once views into it are handed out
+      if (m_scratch.empty()) {
+        m_scratch.reserve(static_cast<std::size_t>(m_end - m_view.data()));
+      }
+
+      m_offset = m_scratch.size();
+      m_scratch.append(m_view);
+    }
+
+    m_scratch.append(piece);
+  }
+
+  [[nodiscard]] std::string_view finish() const
+  {
+    if (m_offset == npos) {
+      return m_view;
+    }
+    return std::string_view(m_scratch).substr(m_offset);
+  }
+};
+
+// pos is at the opening quote, returns the position past the closing one
+std::size_t double_quoted(
+    word_builder& word, std::string_view line, std::size_t pos
+)
+{
+  const auto open = pos++;
+  while (true) {
+    const auto end = line.find_first_of("\"\\", pos);
+    if (end == npos) {
+      throw error<error_code::unterminated_quote>(line.substr(open));
+    }
+
+    word.append(line.substr(pos, end - pos));
+    if (line[end] == '"') {
+      return end + 1;
+    }
+
+    if (end + 1 == std::size(line)) {
+      throw error<error_code::unterminated_quote>(line.substr(open));
+    }
+
+    const auto next = line[end + 1];
+    if (next != '\n') {
+      word.append(
+          is_dquote_escape(next) ? line.substr(end + 1, 1)
+                                 : line.substr(end, 2)
+      );
+    }
+    pos = end + 2;
+  }
+}
+
+}  // namespace
+
+namespace poafloc
+{
+
+namespace detail
+{
+
+void split_words(
+    std::string_view line,
+    std::string& scratch,
+    std::vector<std::string_view>& words
+)
+{
+  scratch.clear();
+
+  const auto size = std::size(line);
+  std::size_t pos = 0;
+  while (pos < size) {
+    if (is_blank(line[pos])) {
+      pos++;
+      continue;
+    }
+
+    if (line.substr(pos, 2) == "\\\n") {
+      pos += 2;
+      continue;
+    }
+
+    word_builder word(scratch, line);
+    while (pos < size && !is_blank(line[pos])) {
+      switch (line[pos]) {
+        case '\'': {
+          const auto end = line.find('\'', pos + 1);
+          if (end == npos) {
+            throw error<error_code::unterminated_quote>(line.substr(pos));
+          }
+          word.append(line.substr(pos + 1, end - pos - 1));
+          pos = end + 1;
+          break;
+        }
+        case '"':
+          pos = double_quoted(word, line, pos);
+          break;
+        case '\\':
+          // a trailing backslash has nothing to escape and stays as is
+          if (pos + 1 == size) {
+            word.append(line.substr(pos, 1));
+          } else if (line[pos + 1] != '\n') {
+            word.append(line.substr(pos + 1, 1));
+          }
+          pos += 2;
+          break;
+        default: {
+          auto end = pos + 1;
+          while (end < size && !is_special(line[end])) {
+            end++;
+          }
+          word.append(line.substr(pos, end - pos));
+          pos = end;
+          break;
+        }
+      }
+    }
+
+    words.push_back(word.finish());
+  }
+}
+
+}  // namespace detail
+
+std::span<const std::string_view> tokenizer::split(std::string_view line)
+{
+  m_words.clear();
+  detail::split_words(line, m_scratch, m_words);
+  return m_words;
+}
+
+}  // namespace poafloc
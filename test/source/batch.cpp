@@ -0,0 +1,119 @@
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include "poafloc/error.hpp"
+#include "poafloc/poafloc.hpp"
+
+using namespace poafloc;  // NOLINT
+
+namespace
+{
+
+struct arguments
+{
+  bool flag = false;
+  int value = 0;
+  std::string name;
+
+  void set_name(std::string_view val)
+  {
+    if (val == "throw") {
+      throw std::runtime_error("setter");
+    }
+    name = val;
+  }
+};
+
+const auto program = parser<arguments> {
+    positional {
+        argument {"name", &arguments::set_name},
+    },
+    group {
+        "unnamed",
+        boolean {"f flag", &arguments::flag, "something"},
+        direct {"v value", &arguments::value, "NUM something"},
+    },
+};
+
+// every third line has a value that does not convert
+std::vector<std::vector<std::string>> make_lines(std::size_t size)
+{
+  std::vector<std::vector<std::string>> lines;
+  lines.reserve(size);
+  for (std::size_t i = 0; i < size; i++) {
+    const auto value = i % 3 == 2 ? "x" : std::to_string(i);
+    lines.push_back({"test", "-f", "--value=" + value, "line"});
+  }
+  return lines;
+}
+
+}  // namespace
+
+// NOLINTBEGIN(*complexity*)
+TEST_CASE("batch", "[poafloc/batch]")
+{
+  const auto lines = make_lines(1000);
+
+  std::vector<std::vector<const char*>> storage;
+  std::vector<argv_view> argvs;
+  storage.reserve(std::size(lines));
+  for (const auto& line : lines) {
+    auto& argv = storage.emplace_back();
+    for (const auto& arg : line) {
+      argv.push_back(arg.c_str());
+    }
+    argvs.emplace_back(argv);
+  }
+
+  std::vector<arguments> records(std::size(lines));
+
+  SECTION("threads")
+  {
+    const auto threads = GENERATE(0U, 1U, 3U, 64U);
+    const auto res = program.parse_batch(argvs, records, threads);
+
+    REQUIRE(std::size(res) == std::size(lines));
+    for (std::size_t i = 0; i < std::size(lines); i++) {
+      if (i % 3 == 2) {
+        REQUIRE(!res[i].has_value());
+        REQUIRE(res[i].error().code == error_code::invalid_argument);
+        REQUIRE(res[i].error().index == 2);
+        REQUIRE(res[i].error().token == "x");
+        continue;
+      }
+
+      REQUIRE(res[i].has_value());
+      REQUIRE(records[i].flag);
+      REQUIRE(records[i].value == static_cast<int>(i));
+      REQUIRE(records[i].name == "line");
+    }
+  }
+
+  SECTION("empty")
+  {
+    REQUIRE(program.parse_batch({}, std::span<arguments> {}).empty());
+  }
+
+  SECTION("size mismatch")
+  {
+    records.pop_back();
+    REQUIRE_THROWS_AS(
+        (void)program.parse_batch(argvs, records), std::invalid_argument
+    );
+  }
+
+  SECTION("setter exception")
+  {
+    const char* line[] = {"test", "throw"};  // NOLINT(*avoid-c-arrays*)
+    argvs[500] = line;
+    REQUIRE_THROWS_AS(
+        (void)program.parse_batch(argvs, records, 4), std::runtime_error
+    );
+  }
+}
+// NOLINTEND(*complexity*)
@@ -0,0 +1,81 @@
+#define CATCH_CONFIG_RUNTIME_STATIC_REQUIRE
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "poafloc/poafloc.hpp"
+
+using namespace poafloc::detail;  // NOLINT
+
+// NOLINTBEGIN(*complexity*, *magic*)
+TEST_CASE("type", "[poafloc/classify]")
+{
+  STATIC_REQUIRE(classify_type("") == arg_type::positional);
+  STATIC_REQUIRE(classify_type("value") == arg_type::positional);
+  STATIC_REQUIRE(classify_type("a-b") == arg_type::positional);
+  STATIC_REQUIRE(classify_type("-") == arg_type::dash);
+  STATIC_REQUIRE(classify_type("--") == arg_type::terminator);
+  STATIC_REQUIRE(classify_type("-a") == arg_type::short_opts);
+  STATIC_REQUIRE(classify_type("-=") == arg_type::short_opts);
+  STATIC_REQUIRE(classify_type("-abc") == arg_type::short_opts);
+  STATIC_REQUIRE(classify_type("--a") == arg_type::long_opt);
+  STATIC_REQUIRE(classify_type("---") == arg_type::long_opt);
+}
+
+TEST_CASE("equal", "[poafloc/classify]")
+{
+  constexpr auto npos = std::string_view::npos;
+
+  STATIC_REQUIRE(classify("--name").equal == npos);
+  STATIC_REQUIRE(classify("--name=").equal == 6);
+  STATIC_REQUIRE(classify("--name=value").equal == 6);
+  STATIC_REQUIRE(classify("--name=a=b").equal == 6);
+  STATIC_REQUIRE(classify("--=").equal == 2);
+
+  STATIC_REQUIRE(classify("-n=value").equal == npos);
+  STATIC_REQUIRE(classify("a=b").equal == npos);
+  STATIC_REQUIRE(classify("-").equal == npos);
+  STATIC_REQUIRE(classify("--").equal == npos);
+}
+
+TEST_CASE("argv", "[poafloc/classify]")
+{
+  struct arguments
+  {
+    std::string name;
+    bool flag = false;
+    std::vector<std::string> rest;
+
+    void add(std::string_view value) { rest.emplace_back(value); }
+  } args;
+
+  using poafloc::argument_list;
+  using poafloc::boolean;
+  using poafloc::direct;
+  using poafloc::group;
+  using poafloc::positional;
+
+  auto program = poafloc::parser<arguments> {
+      positional {
+          argument_list {"rest", &arguments::add},
+      },
+      group {
+          "unnamed",
+          direct {"n name", &arguments::name, "NAME something"},
+          boolean {"f flag", &arguments::flag, "something"},
+      },
+  };
+
+  std::vector<const char*> argv = {
+      "program", "--name=a=b", "-f", "--", "--flag", "-", "x=y",
+  };
+  program(args, static_cast<int>(std::size(argv)), argv.data());
+
+  REQUIRE(args.name == "a=b");
+  REQUIRE(args.flag);
+  REQUIRE(args.rest == std::vector<std::string> {"--flag", "-", "x=y"});
+}
+// NOLINTEND(*complexity*, *magic*)
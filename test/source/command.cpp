@@ -0,0 +1,163 @@
+#define CATCH_CONFIG_RUNTIME_STATIC_REQUIRE
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "poafloc/command.hpp"
+
+#include "poafloc/error.hpp"
+#include "poafloc/poafloc.hpp"
+
+using namespace poafloc;  // NOLINT
+
+namespace
+{
+
+struct clone_args
+{
+  std::string url;
+  bool quiet = false;
+};
+
+struct push_args
+{
+  int depth = 0;
+};
+
+// counts the parsers built, only the selected subcommand may build one
+int built = 0;  // NOLINT(*global*)
+
+constexpr auto cli = commands {
+    command {
+        "clone",
+        []
+        {
+          built++;
+          return parser<clone_args> {
+              positional {
+                  argument {"url", &clone_args::url},
+              },
+              group {
+                  "unnamed",
+                  boolean {"q quiet", &clone_args::quiet, "Be quiet"},
+              },
+          };
+        },
+        [](clone_args& args) { return args.quiet ? 10 : 11; },
+        "Clone a repository",
+    },
+    command {
+        "push",
+        []
+        {
+          built++;
+          return parser<push_args> {
+              group {
+                  "unnamed",
+                  direct {"d depth", &push_args::depth, "NUM Depth"},
+              },
+          };
+        },
+        [](push_args& args) { return args.depth; },
+        "Push changes",
+    },
+    command {
+        "status",
+        []
+        {
+          built++;
+          return parser<push_args> {
+              group {
+                  "unnamed",
+                  direct {"d depth", &push_args::depth, "NUM Depth"},
+              },
+          };
+        },
+        [](push_args&) { return 0; },
+        "Show the status",
+    },
+};
+
+int run(std::vector<const char*> argv)
+{
+  return cli(static_cast<int>(std::size(argv)), argv.data());
+}
+
+}  // namespace
+
+// NOLINTBEGIN(*complexity*)
+TEST_CASE("table", "[poafloc/command]")
+{
+  STATIC_REQUIRE(cli.find("clone") == 0);
+  STATIC_REQUIRE(cli.find("push") == 1);
+  STATIC_REQUIRE(cli.find("status") == 2);
+  STATIC_REQUIRE(!cli.find("pull").has_value());
+  STATIC_REQUIRE(!cli.find("").has_value());
+  STATIC_REQUIRE(!cli.find("clones").has_value());
+}
+
+TEST_CASE("dispatch", "[poafloc/command]")
+{
+  built = 0;
+
+  SECTION("first")
+  {
+    REQUIRE(run({"tool", "clone", "-q", "url"}) == 10);
+    REQUIRE(built == 1);
+  }
+
+  SECTION("second")
+  {
+    REQUIRE(run({"tool", "push", "--depth=7"}) == 7);
+    REQUIRE(built == 1);
+  }
+
+  SECTION("subcommand help")
+  {
+    REQUIRE(run({"tool", "clone", "--help"}) == 0);
+    REQUIRE(built == 1);
+  }
+
+  SECTION("help")
+  {
+    REQUIRE(run({"tool", "--help"}) == 0);
+    REQUIRE(built == 0);
+  }
+
+  SECTION("invalid")
+  {
+    REQUIRE_THROWS_AS(run({"tool"}), error<error_code::missing_command>);
+    REQUIRE_THROWS_AS(
+        run({"tool", "pull"}), error<error_code::unknown_command>
+    );
+    REQUIRE_THROWS_AS(
+        run({"tool", "clone"}), error<error_code::missing_positional>
+    );
+  }
+}
+
+TEST_CASE("duplicate", "[poafloc/command]")
+{
+  const auto make = []
+  {
+    return parser<push_args> {
+        group {
+            "unnamed",
+            direct {"d depth", &push_args::depth, "NUM Depth"},
+        },
+    };
+  };
+  const auto run = [](push_args&) { return 0; };
+
+  REQUIRE_THROWS_AS(
+      commands(
+          command {"push", make, run, "Push"},
+          command {"push", make, run, "Push again"}
+      ),
+      error<error_code::duplicate_command>
+  );
+}
+// NOLINTEND(*complexity*)
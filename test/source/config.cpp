@@ -0,0 +1,127 @@
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "poafloc/config.hpp"
+
+#include "poafloc/error.hpp"
+#include "poafloc/poafloc.hpp"
+
+using namespace poafloc;  // NOLINT
+
+// NOLINTBEGIN(*complexity*)
+TEST_CASE("config", "[poafloc/config]")
+{
+  struct arguments
+  {
+    int threads = 0;
+    bool verbose = false;
+    bool color = false;
+    std::string name;
+    std::vector<std::string> list;
+  } args;
+
+  const auto program = parser<arguments> {
+      group {
+          "general",
+          direct {"t threads", &arguments::threads, "NUM Threads"},
+          boolean {"v verbose", &arguments::verbose, "Verbose"},
+          boolean {"color", &arguments::color, "Color"},
+      },
+      group {
+          "output",
+          direct {"n name", &arguments::name, "NAME Name"},
+          list {"l list", &arguments::list, "VALUE Values"},
+      },
+  };
+
+  SECTION("load")
+  {
+    SECTION("keys")
+    {
+      program.load(
+          args,
+          "# comment\n"
+          "threads = 8\r\n"
+          "verbose\n"
+          "\n"
+          "; another comment\n"
+          "name=\"  spaced  \"\n"
+          "list = a\n"
+          "list = b\n"
+      );
+      REQUIRE(args.threads == 8);
+      REQUIRE(args.verbose == true);
+      REQUIRE(args.name == "  spaced  ");
+      REQUIRE(args.list == std::vector<std::string> {"a", "b"});
+    }
+
+    SECTION("sections")
+    {
+      program.load(
+          args,
+          "[general]\n"
+          "thr = 4\n"
+          "color = yes\n"
+          "verbose = off\n"
+          "[ output ]\n"
+          "name = out\n"
+      );
+      REQUIRE(args.threads == 4);
+      REQUIRE(args.color == true);
+      REQUIRE(args.verbose == false);
+      REQUIRE(args.name == "out");
+    }
+
+    SECTION("wrong section")
+    {
+      const std::string_view text = "[output]\nthreads = 4\n";
+      const auto res = program.try_load(args, text);
+      REQUIRE(!res.has_value());
+      REQUIRE(res.error().code == error_code::unknown_option);
+      REQUIRE(res.error().index == 2);
+      REQUIRE(res.error().token == "threads");
+    }
+
+    SECTION("errors")
+    {
+      const auto code = [&](std::string_view text)
+      { return program.try_load(args, text).error().code; };
+
+      REQUIRE(code("[general\n") == error_code::invalid_config);
+      REQUIRE(code("[missing]\n") == error_code::unknown_section);
+      REQUIRE(code("[Informational Options]\n") == error_code::unknown_section);
+      REQUIRE(code("help\n") == error_code::unknown_option);
+      REQUIRE(code("unknown = 1\n") == error_code::unknown_option);
+      REQUIRE(code("Bad = 1\n") == error_code::invalid_option);
+      REQUIRE(code("threads = many\n") == error_code::invalid_argument);
+      REQUIRE(code("threads\n") == error_code::missing_argument);
+      REQUIRE(code("verbose = maybe\n") == error_code::invalid_argument);
+      REQUIRE_THROWS_AS(
+          program.load(args, "\n\nthreads = x"),
+          error<error_code::invalid_argument>
+      );
+    }
+  }
+
+  SECTION("file")
+  {
+    const auto path =
+        std::filesystem::temp_directory_path() / "poafloc-config.ini";
+    std::ofstream(path, std::ios::binary) << "threads = 2\nname = file\n";
+
+    const config_file file(path);
+    program.load(args, file.text());
+    program(args, std::vector<std::string_view> {"test", "--name=cli"});
+    REQUIRE(args.threads == 2);
+    REQUIRE(args.name == "cli");
+
+    std::filesystem::remove(path);
+    REQUIRE_THROWS_AS(config_file(path), error<error_code::unreadable_config>);
+  }
+}
+// NOLINTEND(*complexity*)
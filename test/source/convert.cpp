@@ -0,0 +1,229 @@
+#define CATCH_CONFIG_RUNTIME_STATIC_REQUIRE
+
+#include <bit>
+#include <charconv>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "poafloc/convert.hpp"
+#include "poafloc/error.hpp"
+
+using namespace poafloc;  // NOLINT
+
+namespace user
+{
+
+struct point
+{
+  int x = 0;
+  int y = 0;
+};
+
+bool from_string(std::string_view value, point& out)
+{
+  const auto pos = value.find(',');
+  if (pos == std::string_view::npos) {
+    return false;
+  }
+
+  return poafloc::convert(value.substr(0, pos), out.x) == std::errc {}
+      && poafloc::convert(value.substr(pos + 1), out.y) == std::errc {};
+}
+
+struct word
+{
+  std::string value;
+
+  friend std::istream& operator>>(std::istream& ist, word& out)
+  {
+    return ist >> out.value;
+  }
+};
+
+}  // namespace user
+
+namespace
+{
+
+// floating point values are compared exactly, bit for bit
+template<std::floating_point T>
+auto bits(T value)
+{
+  if constexpr (sizeof(T) == sizeof(std::uint32_t)) {
+    return std::bit_cast<std::uint32_t>(value);
+  } else {
+    return std::bit_cast<std::uint64_t>(value);
+  }
+}
+
+}  // namespace
+
+// NOLINTBEGIN(*complexity*, *magic*)
+TEST_CASE("integer", "[poafloc/convert]")
+{
+  SECTION("decimal")
+  {
+    REQUIRE(convert<int>("135") == 135);
+    REQUIRE(convert<int>("+135") == 135);
+    REQUIRE(convert<int>("-135") == -135);
+    REQUIRE(convert<int>("0") == 0);
+    REQUIRE(convert<int>("010") == 10);
+  }
+
+  SECTION("prefix")
+  {
+    REQUIRE(convert<int>("0x1f") == 31);
+    REQUIRE(convert<int>("0X1F") == 31);
+    REQUIRE(convert<int>("0o17") == 15);
+    REQUIRE(convert<int>("0b101") == 5);
+    REQUIRE(convert<int>("-0x10") == -16);
+  }
+
+  SECTION("limits")
+  {
+    using limits = std::numeric_limits<std::int8_t>;
+    REQUIRE(convert<std::int8_t>("127") == limits::max());
+    REQUIRE(convert<std::int8_t>("-128") == limits::min());
+    REQUIRE(convert<std::uint64_t>("18446744073709551615") == UINT64_MAX);
+    REQUIRE(convert<std::int64_t>("-9223372036854775808") == INT64_MIN);
+  }
+
+  SECTION("overflow")
+  {
+    REQUIRE_THROWS_AS(convert<std::int8_t>("128"), error<error_code::out_of_range>);
+    REQUIRE_THROWS_AS(convert<std::int8_t>("-129"), error<error_code::out_of_range>);
+    REQUIRE_THROWS_AS(convert<unsigned>("-1"), error<error_code::out_of_range>);
+    REQUIRE_THROWS_AS(convert<std::uint64_t>("18446744073709551616"), error<error_code::out_of_range>);
+    REQUIRE_THROWS_AS(convert<std::uint8_t>("0x100"), error<error_code::out_of_range>);
+  }
+
+  SECTION("invalid")
+  {
+    REQUIRE_THROWS_AS(convert<int>(""), error<error_code::invalid_argument>);
+    REQUIRE_THROWS_AS(convert<int>("-"), error<error_code::invalid_argument>);
+    REQUIRE_THROWS_AS(convert<int>("--1"), error<error_code::invalid_argument>);
+    REQUIRE_THROWS_AS(convert<int>("+-1"), error<error_code::invalid_argument>);
+    REQUIRE_THROWS_AS(convert<int>("12a"), error<error_code::invalid_argument>);
+    REQUIRE_THROWS_AS(convert<int>("0x"), error<error_code::invalid_argument>);
+    REQUIRE_THROWS_AS(convert<int>("0b102"), error<error_code::invalid_argument>);
+    REQUIRE_THROWS_AS(convert<int>(" 1"), error<error_code::invalid_argument>);
+  }
+
+  SECTION("long decimal")
+  {
+    REQUIRE(convert<std::int64_t>("12345678") == 12345678);
+    REQUIRE(convert<std::int64_t>("123456789") == 123456789);
+    REQUIRE(convert<std::int64_t>("-1234567890123456") == -1234567890123456);
+    REQUIRE(convert<std::uint64_t>("9999999999999999999") == 9999999999999999999U);
+    REQUIRE(convert<std::uint64_t>("00000000000000000001") == 1);
+    REQUIRE(convert<std::uint32_t>("4294967295") == UINT32_MAX);
+    REQUIRE_THROWS_AS(convert<std::uint32_t>("4294967296"), error<error_code::out_of_range>);
+    REQUIRE_THROWS_AS(convert<std::int64_t>("1234567/"), error<error_code::invalid_argument>);
+    REQUIRE_THROWS_AS(convert<std::int64_t>("12345678:"), error<error_code::invalid_argument>);
+    REQUIRE_THROWS_AS(convert<std::int64_t>("1234 5678"), error<error_code::invalid_argument>);
+    REQUIRE_THROWS_AS(convert<std::int64_t>("123456789012345678x"), error<error_code::invalid_argument>);
+  }
+
+  SECTION("non-throwing")
+  {
+    int value = 7;
+    REQUIRE(convert("13", value) == std::errc {});
+    REQUIRE(value == 13);
+    REQUIRE(convert("x", value) == std::errc::invalid_argument);
+    REQUIRE(convert("99999999999", value) == std::errc::result_out_of_range);
+    REQUIRE(value == 13);
+  }
+}
+
+TEST_CASE("floating", "[poafloc/convert]")
+{
+  REQUIRE(bits(convert<double>("1.5")) == bits(1.5));
+  REQUIRE(bits(convert<double>("+1.5")) == bits(1.5));
+  REQUIRE(bits(convert<double>("-2.5e2")) == bits(-250.0));
+  REQUIRE(bits(convert<float>("0.25")) == bits(0.25F));
+
+  REQUIRE_THROWS_AS(convert<double>("1.5x"), error<error_code::invalid_argument>);
+  REQUIRE_THROWS_AS(convert<double>("+-1"), error<error_code::invalid_argument>);
+  REQUIRE_THROWS_AS(convert<double>(""), error<error_code::invalid_argument>);
+  REQUIRE_THROWS_AS(convert<float>("1e100"), error<error_code::out_of_range>);
+}
+
+TEST_CASE("floating decimal", "[poafloc/convert]")
+{
+  SECTION("same as from_chars")
+  {
+    const auto check = [](const std::string& value)
+    {
+      double expected = 0;
+      const auto* end = value.data() + value.size();
+      std::from_chars(value.data(), end, expected);
+      REQUIRE(bits(convert<double>(value)) == bits(expected));
+
+      float expected_float = 0;
+      std::from_chars(value.data(), end, expected_float);
+      REQUIRE(bits(convert<float>(value)) == bits(expected_float));
+    };
+
+    for (std::uint64_t i = 1; i < 1'000'000'000'000'000'000U; i *= 7) {
+      const auto digits = std::to_string(i);
+      for (std::size_t dot = 1; dot < digits.size(); dot++) {
+        check(digits.substr(0, dot) + "." + digits.substr(dot));
+        check("-" + digits.substr(0, dot) + "." + digits.substr(dot));
+      }
+      check(digits);
+    }
+    check("0.1");
+    check("0.3");
+    check("9007199254740993");
+    check("0.9007199254740993");
+  }
+
+  SECTION("left to from_chars")
+  {
+    REQUIRE(bits(convert<double>("1.")) == bits(1.0));
+    REQUIRE(bits(convert<double>(".5")) == bits(0.5));
+    REQUIRE(bits(convert<double>("1e3")) == bits(1000.0));
+    REQUIRE(bits(convert<double>("12345678901234567890.5")) == bits(12345678901234567890.5));
+    REQUIRE(bits(convert<double>("-0.0")) == bits(-0.0));
+    REQUIRE(bits(convert<double>("0.0")) == bits(0.0));
+    REQUIRE_THROWS_AS(convert<double>("."), error<error_code::invalid_argument>);
+    REQUIRE_THROWS_AS(convert<double>("-"), error<error_code::invalid_argument>);
+    REQUIRE_THROWS_AS(convert<double>("1.2.3"), error<error_code::invalid_argument>);
+  }
+}
+
+TEST_CASE("other", "[poafloc/convert]")
+{
+  SECTION("character")
+  {
+    REQUIRE(convert<char>("c") == 'c');
+    REQUIRE_THROWS_AS(convert<char>("cc"), error<error_code::invalid_argument>);
+  }
+
+  SECTION("string")
+  {
+    REQUIRE(convert<std::string>("some thing") == "some thing");
+  }
+
+  SECTION("user")
+  {
+    const auto point = convert<user::point>("3,-4");
+    REQUIRE(point.x == 3);
+    REQUIRE(point.y == -4);
+    REQUIRE_THROWS_AS(convert<user::point>("3"), error<error_code::invalid_argument>);
+  }
+
+  SECTION("stream")
+  {
+    REQUIRE(convert<user::word>("word").value == "word");
+    REQUIRE_THROWS_AS(convert<user::word>("two words"), error<error_code::invalid_argument>);
+  }
+}
+
+// NOLINTEND(*complexity*, *magic*)
@@ -0,0 +1,147 @@
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "poafloc/error.hpp"
+#include "poafloc/poafloc.hpp"
+
+using namespace poafloc;  // NOLINT
+
+namespace
+{
+
+// sets a variable for the duration of a test
+class scoped_env
+{
+  std::string m_name;
+
+public:
+  scoped_env(std::string name, const std::string& value)
+      : m_name(std::move(name))
+  {
+    ::setenv(m_name.c_str(), value.c_str(), 1);  // NOLINT(*mt-unsafe*)
+  }
+
+  scoped_env(const scoped_env&) = delete;
+  scoped_env(scoped_env&&) = delete;
+  scoped_env& operator=(const scoped_env&) = delete;
+  scoped_env& operator=(scoped_env&&) = delete;
+
+  ~scoped_env() { ::unsetenv(m_name.c_str()); }  // NOLINT(*mt-unsafe*)
+};
+
+}  // namespace
+
+// NOLINTBEGIN(*complexity*)
+TEST_CASE("environment", "[poafloc/environment]")
+{
+  struct arguments
+  {
+    int threads = 0;
+    bool verbose = false;
+    std::string name;
+    std::vector<std::string> list;
+  } args;
+
+  auto program = parser<arguments> {
+      group {
+          "unnamed",
+          direct {"t threads", &arguments::threads, "NUM Threads"},
+          boolean {"v verbose", &arguments::verbose, "Verbose"},
+          direct {"n name $POAFLOC_TEST_NAME", &arguments::name, "NAME Name"},
+          list {"l list", &arguments::list, "VALUE Values"},
+      },
+  };
+
+  SECTION("names")
+  {
+    // string literals are validated at compile time, exercise the runtime path
+    const auto construct = [](std::string_view opts)
+    { return direct {opts, &arguments::name, "NAME Name"}; };
+
+    REQUIRE_THROWS_AS(construct("n $lower"), error<error_code::invalid_option>);
+    REQUIRE_THROWS_AS(construct("n $1ST"), error<error_code::invalid_option>);
+    REQUIRE_THROWS_AS(construct("n $"), error<error_code::invalid_option>);
+    REQUIRE_THROWS_AS(
+        construct("n $A $B"), error<error_code::duplicate_option>
+    );
+    REQUIRE(construct("n name $APP_NAME_2").env() == "APP_NAME_2");
+  }
+
+  SECTION("fallback")
+  {
+    program.env_prefix("POAFLOC_TEST_");
+
+    const scoped_env threads("POAFLOC_TEST_THREADS", "8");
+    const scoped_env verbose("POAFLOC_TEST_VERBOSE", "1");
+    const scoped_env name("POAFLOC_TEST_NAME", "env");
+    const scoped_env list("POAFLOC_TEST_LIST", "a");
+
+    SECTION("environment")
+    {
+      program(args, std::vector<std::string_view> {"test"});
+      REQUIRE(args.threads == 8);
+      REQUIRE(args.verbose == true);
+      REQUIRE(args.name == "env");
+      REQUIRE(args.list == std::vector<std::string> {"a"});
+    }
+
+    SECTION("command line first")
+    {
+      program(
+          args,
+          std::vector<std::string_view> {"test", "-t4", "--name=cli", "-l", "b"}
+      );
+      REQUIRE(args.threads == 4);
+      REQUIRE(args.verbose == true);
+      REQUIRE(args.name == "cli");
+      REQUIRE(args.list == std::vector<std::string> {"b"});
+    }
+
+    SECTION("disabled")
+    {
+      const scoped_env off("POAFLOC_TEST_VERBOSE", "0");
+      program(args, std::vector<std::string_view> {"test"});
+      REQUIRE(args.verbose == false);
+    }
+
+    SECTION("invalid")
+    {
+      const scoped_env bad("POAFLOC_TEST_THREADS", "many");
+      const auto res =
+          program.try_parse(args, std::vector<std::string_view> {"test"});
+      REQUIRE(!res.has_value());
+      REQUIRE(res.error().code == error_code::invalid_environment);
+      REQUIRE(res.error().token == "POAFLOC_TEST_THREADS=many");
+    }
+  }
+
+  SECTION("explicit only")
+  {
+    const scoped_env threads("POAFLOC_TEST_THREADS", "8");
+    const scoped_env name("POAFLOC_TEST_NAME", "env");
+
+    program(args, std::vector<std::string_view> {"test"});
+    REQUIRE(args.threads == 0);
+    REQUIRE(args.name == "env");
+  }
+
+  SECTION("duplicate")
+  {
+    auto clash = parser<arguments> {
+        group {
+            "unnamed",
+            direct {"t threads", &arguments::threads, "NUM Threads"},
+            direct {"n name $APP_THREADS", &arguments::name, "NAME Name"},
+        },
+    };
+    REQUIRE_NOTHROW(clash.env_prefix("OTHER_"));
+    REQUIRE_THROWS_AS(
+        clash.env_prefix("APP_"), error<error_code::duplicate_option>
+    );
+  }
+}
+// NOLINTEND(*complexity*)
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "poafloc/poafloc.hpp"
+
+// The parser of the tests that follow how a command line is taken apart: a
+// short cluster, long options with and without a value, and positional files
+namespace fixture
+{
+
+struct arguments
+{
+  int threads = 0;
+  bool verbose = false;
+  std::string output;
+  std::vector<std::string> files;
+};
+
+inline auto make_program()
+{
+  using poafloc::argument_list;
+  using poafloc::boolean;
+  using poafloc::direct;
+  using poafloc::group;
+  using poafloc::positional;
+
+  return poafloc::parser<arguments> {
+      positional {
+          argument_list {"files", &arguments::files},
+      },
+      group {
+          "unnamed",
+          direct {"t threads", &arguments::threads, "NUM Threads"},
+          boolean {"v verbose", &arguments::verbose, "Verbose"},
+          direct {"o output", &arguments::output, "FILE Output"},
+      },
+  };
+}
+
+}  // namespace fixture
@@ -0,0 +1,130 @@
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "poafloc/error.hpp"
+#include "poafloc/lazy.hpp"
+#include "poafloc/poafloc.hpp"
+
+using namespace poafloc;  // NOLINT
+
+namespace
+{
+
+// comma separated numbers, counting how many times they were converted
+struct numbers
+{
+  static inline std::size_t conversions = 0;  // NOLINT(*non-const*)
+  std::vector<int> values;
+};
+
+bool from_string(std::string_view value, numbers& out)
+{
+  numbers::conversions++;
+  while (!value.empty()) {
+    const auto end = value.find(',');
+    int num = 0;
+    if (convert(value.substr(0, end), num) != std::errc {}) {
+      return false;
+    }
+    out.values.push_back(num);
+    value.remove_prefix(end == std::string_view::npos ? std::size(value)
+                                                      : end + 1);
+  }
+  return true;
+}
+
+}  // namespace
+
+// NOLINTBEGIN(*complexity*, *magic*)
+TEST_CASE("lazy", "[poafloc/lazy]")
+{
+  struct arguments
+  {
+    lazy<numbers> ids;
+    lazy<int> level = lazy<int>(3);
+    lazy<std::string, std::string> name;
+  } args;
+
+  const auto program = parser<arguments> {
+      group {
+          "unnamed",
+          direct {"i ids", &arguments::ids, "LIST Identifiers"},
+          direct {"l level", &arguments::level, "NUM Level"},
+          direct {"n name", &arguments::name, "NAME Name"},
+      },
+  };
+
+  SECTION("deferred")
+  {
+    numbers::conversions = 0;
+
+    const std::vector<std::string_view> line = {"prog", "--ids=1,2,3"};
+    program(args, line);
+
+    REQUIRE(args.ids.has_text());
+    REQUIRE(args.ids.text() == "1,2,3");
+    REQUIRE(numbers::conversions == 0);
+
+    REQUIRE(args.ids->values == std::vector<int> {1, 2, 3});
+    REQUIRE(args.ids.get().values.size() == 3);
+    REQUIRE(numbers::conversions == 1);
+  }
+
+  SECTION("defaults")
+  {
+    const std::vector<std::string_view> line = {"prog"};
+    program(args, line);
+
+    REQUIRE(!args.level.has_text());
+    REQUIRE(*args.level == 3);
+    REQUIRE(!args.name.has_text());
+    REQUIRE(args.name->empty());
+  }
+
+  SECTION("replaced")
+  {
+    const std::vector<std::string_view> line = {"prog", "-l", "5", "-l7"};
+    program(args, line);
+    REQUIRE(*args.level == 7);
+
+    args.level.assign("9");
+    REQUIRE(*args.level == 9);
+  }
+
+  SECTION("errors")
+  {
+    // parsing succeeds, the value is only rejected once it is read
+    const std::vector<std::string_view> line = {
+        "prog", "--level=many", "--ids=1,x"
+    };
+    REQUIRE(program.try_parse(args, line).has_value());
+
+    REQUIRE_THROWS_AS(*args.level, error<error_code::invalid_argument>);
+    REQUIRE_THROWS_AS(*args.level, error<error_code::invalid_argument>);
+    REQUIRE_THROWS_AS(*args.ids, error<error_code::invalid_argument>);
+
+    args.level.assign("99999999999");
+    REQUIRE_THROWS_AS(*args.level, error<error_code::out_of_range>);
+  }
+
+  SECTION("owned")
+  {
+    {
+      std::string buffer = "prog";
+      parse_session session(program, args);
+      REQUIRE(session.feed(buffer).has_value());
+      buffer = "--name=first";
+      REQUIRE(session.feed(buffer).has_value());
+      buffer = "overwritten";
+      REQUIRE(session.finish().has_value());
+    }
+
+    REQUIRE(args.name.text() == "first");
+    REQUIRE(*args.name == "first");
+  }
+}
+// NOLINTEND(*complexity*, *magic*)
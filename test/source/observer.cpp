@@ -0,0 +1,120 @@
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "poafloc/error.hpp"
+#include "poafloc/observer.hpp"
+#include "poafloc/poafloc.hpp"
+
+#include "fixture.hpp"
+
+using namespace poafloc;  // NOLINT
+
+namespace
+{
+
+struct recorder
+{
+  std::vector<parse_event> events;
+
+  void on_event(const parse_event& event) { events.push_back(event); }
+};
+
+}  // namespace
+
+// NOLINTBEGIN(*complexity*, *magic*)
+TEST_CASE("observer", "[poafloc/observer]")
+{
+  fixture::arguments args;
+  const auto program = fixture::make_program();
+
+  SECTION("events")
+  {
+    recorder obs;
+    const std::vector<std::string_view> line = {
+        "prog", "-vt4", "--out", "a.out", "--thr=2", "--", "x.c", "-y"
+    };
+    REQUIRE(program.try_parse(args, line, obs).has_value());
+    REQUIRE(args.files == std::vector<std::string> {"x.c", "-y"});
+
+    const auto& events = obs.events;
+    REQUIRE(std::size(events) == 9);
+
+    REQUIRE(events[0].kind == event_kind::short_option);
+    REQUIRE(events[0].index == 1);
+    REQUIRE(events[0].option == 1);
+    REQUIRE(events[0].token == "v");
+    REQUIRE(events[0].value.empty());
+
+    REQUIRE(events[1].kind == event_kind::short_option);
+    REQUIRE(events[1].option == 0);
+    REQUIRE(events[1].token == "t");
+    REQUIRE(events[1].value == "4");
+
+    REQUIRE(events[2].kind == event_kind::long_option);
+    REQUIRE(events[2].index == 2);
+    REQUIRE(events[2].option == 2);
+    REQUIRE(events[2].abbreviated);
+    REQUIRE(events[2].value.empty());
+
+    REQUIRE(events[3].kind == event_kind::value);
+    REQUIRE(events[3].index == 3);
+    REQUIRE(events[3].option == 2);
+    REQUIRE(events[3].token == "out");
+    REQUIRE(events[3].value == "a.out");
+
+    REQUIRE(events[4].kind == event_kind::long_option);
+    REQUIRE(events[4].option == 0);
+    REQUIRE(events[4].abbreviated);
+    REQUIRE(events[4].token == "thr");
+    REQUIRE(events[4].value == "2");
+
+    REQUIRE(events[5].kind == event_kind::terminator);
+    REQUIRE(events[5].index == 5);
+    REQUIRE(events[5].option == parse_event::npos);
+
+    REQUIRE(events[6].kind == event_kind::positional);
+    REQUIRE(events[6].option == 0);
+    REQUIRE(events[6].value == "x.c");
+    REQUIRE(events[7].kind == event_kind::positional);
+    REQUIRE(events[7].option == 0);
+    REQUIRE(events[7].value == "-y");
+
+    REQUIRE(events[8].kind == event_kind::end);
+    REQUIRE(events[8].index == 8);
+  }
+
+  SECTION("error")
+  {
+    recorder obs;
+    const std::vector<std::string_view> line = {
+        "prog", "--verbose", "--bogus", "x.c"
+    };
+    const auto res = program.try_parse(args, line, obs);
+    REQUIRE(!res.has_value());
+    REQUIRE(res.error().code == error_code::unknown_option);
+
+    // nothing is decided past the error
+    REQUIRE(std::size(obs.events) == 1);
+    REQUIRE(obs.events[0].kind == event_kind::long_option);
+    REQUIRE(!obs.events[0].abbreviated);
+  }
+
+  SECTION("argv")
+  {
+    recorder obs;
+    const char* argv[] = {"prog", "-v", "x.c"};  // NOLINT(*c-arrays*)
+    REQUIRE(program.try_parse(args, 3, argv, obs).has_value());
+    REQUIRE(std::size(obs.events) == 3);
+    REQUIRE(args.verbose);
+
+    // unobserved parses are unaffected
+    fixture::arguments plain;
+    program(plain, 3, argv);
+    REQUIRE(plain.verbose);
+    REQUIRE(std::size(obs.events) == 3);
+  }
+}
+// NOLINTEND(*complexity*, *magic*)
@@ -0,0 +1,117 @@
+#define CATCH_CONFIG_RUNTIME_STATIC_REQUIRE
+
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "poafloc/poafloc.hpp"
+
+using namespace based::literals;  // NOLINT
+using namespace poafloc::detail;  // NOLINT
+
+namespace
+{
+
+std::vector<std::string> make_names(std::size_t count)
+{
+  std::vector<std::string> res;
+  res.reserve(count);
+  for (std::size_t i = 0; i < count; i++) {
+    std::string name = "opt";
+    for (auto num = i; num != 0; num /= 10) {  // NOLINT(*magic*)
+      name += static_cast<char>('a' + (num % 10));  // NOLINT(*magic*)
+    }
+    res.push_back(std::move(name));
+  }
+  return res;
+}
+
+}  // namespace
+
+// NOLINTBEGIN(*complexity*, *magic*)
+TEST_CASE("trie", "[poafloc/option]")
+{
+  trie_t trie;
+  REQUIRE(trie_t::set(trie, "flag", 0_u16));
+  REQUIRE(trie_t::set(trie, "flags", 1_u16));
+  REQUIRE(trie_t::set(trie, "value", 2_u16));
+  REQUIRE(!trie_t::set(trie, "flag", 3_u16));
+
+  REQUIRE(trie_t::get(trie, "flag") == 0_u16);
+  REQUIRE(trie_t::get(trie, "flags") == 1_u16);
+  REQUIRE(trie_t::get(trie, "value") == 2_u16);
+  REQUIRE(trie_t::get(trie, "v") == 2_u16);
+  REQUIRE(trie_t::get(trie, "fla") == std::nullopt);
+  REQUIRE(trie_t::get(trie, "valued") == std::nullopt);
+  REQUIRE(trie_t::get(trie, "other") == std::nullopt);
+}
+
+TEST_CASE("perfect hash", "[poafloc/option]")
+{
+  const auto names = make_names(1000);
+
+  perfect_hash hash;
+  REQUIRE(hash.get("opt") == std::nullopt);
+
+  for (std::size_t i = 0; i < std::size(names); i++) {
+    hash.insert(names[i], option_index::underlying_cast(i));
+  }
+  hash.build();
+
+  for (std::size_t i = 0; i < std::size(names); i++) {
+    REQUIRE(hash.get(names[i]) == option_index::underlying_cast(i));
+  }
+
+  REQUIRE(hash.get("op") == std::nullopt);
+  REQUIRE(hash.get("optx") == std::nullopt);
+  REQUIRE(hash.get("") == std::nullopt);
+}
+
+TEST_CASE("option long", "[poafloc/option]")
+{
+  option_long opts;
+  opts.reserve(3, 14);
+  REQUIRE(opts.set("flag", 0_u16));
+  REQUIRE(opts.set("flags", 1_u16));
+  REQUIRE(opts.set("value", 2_u16));
+  opts.build();
+
+  REQUIRE(opts.get("flag") == 0_u16);
+  REQUIRE(opts.get("flags") == 1_u16);
+  REQUIRE(opts.get("val") == 2_u16);
+  REQUIRE(opts.get("fla") == std::nullopt);
+  REQUIRE_THROWS_AS(opts.get("Flag"), poafloc::error<poafloc::error_code::invalid_option>);
+  REQUIRE(!opts.set("flags", 3_u16));
+}
+
+TEST_CASE("text", "[poafloc/option]")
+{
+  STATIC_REQUIRE(std::is_constructible_v<text, const std::string&>);
+  STATIC_REQUIRE(std::is_constructible_v<text, std::string&>);
+  STATIC_REQUIRE(std::is_constructible_v<text, std::string_view>);
+  STATIC_REQUIRE(!std::is_constructible_v<text, std::string>);
+  STATIC_REQUIRE(!std::is_constructible_v<text, std::string&&>);
+
+  const std::string name = "n name";
+  REQUIRE(text(name).view() == "n name");
+  REQUIRE(!text(name).is_literal());
+  REQUIRE(text("n name").is_literal());
+
+  STATIC_REQUIRE(std::is_constructible_v<option_names, const std::string&>);
+  STATIC_REQUIRE(std::is_constructible_v<option_names, std::string&>);
+  STATIC_REQUIRE(std::is_constructible_v<option_names, std::string_view>);
+  STATIC_REQUIRE(!std::is_constructible_v<option_names, std::string>);
+  STATIC_REQUIRE(!std::is_constructible_v<option_names, std::string&&>);
+
+  const std::string names = "t threads $THREADS";
+  const option_names opts = names;
+  REQUIRE(opts.opt_short() == 't');
+  REQUIRE(opts.opt_long() == "threads");
+  REQUIRE(opts.env() == "THREADS");
+  REQUIRE(!opts.is_literal());
+}
+
+// NOLINTEND(*complexity*, *magic*)
@@ -1,6 +1,13 @@
 #define CATCH_CONFIG_RUNTIME_STATIC_REQUIRE
 
+#include <deque>
+#include <ranges>
+#include <set>
+#include <span>
+#include <string>
 #include <string_view>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #include <catch2/catch_test_macros.hpp>
@@ -32,14 +39,17 @@ TEST_CASE("invalid", "[poafloc/parser]")
     REQUIRE_THROWS_AS(program(args, cmdline), error<error_code::empty>);
   };
 
+  // string literals are validated at compile time, exercise the runtime path
+
   SECTION("short number")
   {
     auto construct = []()
     {
+      const std::string_view opts = "1";
       return parser<arguments> {
           group {
               "unnamed",
-              boolean {"1", &arguments::flag, "NUM something"},
+              boolean {opts, &arguments::flag, "NUM something"},
           },
       };
     };
@@ -50,10 +60,11 @@ TEST_CASE("invalid", "[poafloc/parser]")
   {
     auto construct = []()
     {
+      const std::string_view opts = "FLAG";
       return parser<arguments> {
           group {
               "unnamed",
-              boolean {"FLAG", &arguments::flag, "something"},
+              boolean {opts, &arguments::flag, "something"},
           },
       };
     };
@@ -64,16 +75,47 @@ TEST_CASE("invalid", "[poafloc/parser]")
   {
     auto construct = []()
     {
+      const std::string_view opts = "1value";
       return parser<arguments> {
           group {
               "unnamed",
-              direct {"1value", &arguments::value, "NUM something"},
+              direct {opts, &arguments::value, "NUM something"},
           },
       };
     };
     REQUIRE_THROWS_AS(construct(), error<error_code::invalid_option>);
   }
 
+  SECTION("missing")
+  {
+    auto construct = []()
+    {
+      const std::string_view opts = " ";
+      return parser<arguments> {
+          group {
+              "unnamed",
+              boolean {opts, &arguments::flag, "something"},
+          },
+      };
+    };
+    REQUIRE_THROWS_AS(construct(), error<error_code::missing_option>);
+  }
+
+  SECTION("names duplicate")
+  {
+    auto construct = []()
+    {
+      const std::string_view opts = "f flag g";
+      return parser<arguments> {
+          group {
+              "unnamed",
+              boolean {opts, &arguments::flag, "something"},
+          },
+      };
+    };
+    REQUIRE_THROWS_AS(construct(), error<error_code::duplicate_option>);
+  }
+
   SECTION("short duplicate")
   {
     auto construct = []()
@@ -105,6 +147,62 @@ TEST_CASE("invalid", "[poafloc/parser]")
   }
 }
 
+TEST_CASE("names", "[poafloc/parser]")
+{
+  static constexpr detail::option_names both = "f flag";
+  STATIC_REQUIRE(both.opt_short() == 'f');
+  STATIC_REQUIRE(both.opt_long() == "flag");
+
+  static constexpr detail::option_names spaced = " flag  f ";
+  STATIC_REQUIRE(spaced.opt_short() == 'f');
+  STATIC_REQUIRE(spaced.opt_long() == "flag");
+
+  static constexpr detail::option_names only_long = "flag2";
+  STATIC_REQUIRE(!only_long.has_opt_short());
+  STATIC_REQUIRE(only_long.opt_long() == "flag2");
+}
+
+TEST_CASE("texts", "[poafloc/parser]")
+{
+  struct arguments
+  {
+    std::string name;
+    std::string one;
+  } args;
+
+  // texts that aren't literals only have to outlive the construction
+  const auto make = []
+  {
+    const std::string opts = "n name";
+    const std::string help = "NAME A message too long for any small buffer";
+    const std::string group_name = "runtime";
+    const std::string pos = "one";
+    return parser<arguments> {
+        positional {
+            argument {pos, &arguments::one},
+        },
+        group {
+            group_name,
+            direct {opts, &arguments::name, help},
+        },
+    };
+  };
+
+  const auto original = make();
+  const auto program = original;  // NOLINT(*unnecessary-copy*)
+  program(args, std::vector<std::string_view> {"test", "--name=value", "a"});
+  REQUIRE(args.name == "value");
+  REQUIRE(args.one == "a");
+
+  const auto text = program.help_text("test");
+  REQUIRE(text.starts_with("Usage: test [OPTIONS] one\n\nruntime:\n"));
+  REQUIRE(text.find("--name=NAME") != std::string_view::npos);
+  REQUIRE(
+      text.find("A message too long for any small buffer")
+      != std::string_view::npos
+  );
+}
+
 TEST_CASE("boolean", "[poafloc/parser]")
 {
   struct arguments
@@ -421,6 +519,27 @@ TEST_CASE("direct value", "[poafloc/parser]")
     REQUIRE_THROWS_AS(program(args, cmdline), error<error_code::unknown_option>);
     REQUIRE(args.value == 0);
   }
+
+  SECTION("short invalid")
+  {
+    std::vector<std::string_view> cmdline = {"test", "-v", "13x"};
+    REQUIRE_THROWS_AS(program(args, cmdline), error<error_code::invalid_argument>);
+    REQUIRE(args.value == 0);
+  }
+
+  SECTION("long equal overflow")
+  {
+    std::vector<std::string_view> cmdline = {"test", "--value=99999999999"};
+    REQUIRE_THROWS_AS(program(args, cmdline), error<error_code::out_of_range>);
+    REQUIRE(args.value == 0);
+  }
+
+  SECTION("long hex")
+  {
+    std::vector<std::string_view> cmdline = {"test", "--value", "0x87"};
+    REQUIRE_NOTHROW(program(args, cmdline));
+    REQUIRE(args.value == 135);
+  }
 }
 
 TEST_CASE("list", "[poafloc/parser]")
@@ -580,6 +699,112 @@ TEST_CASE("list", "[poafloc/parser]")
   }
 }
 
+// records how much room was asked for, ahead of the values
+struct tracked : std::vector<int>
+{
+  std::vector<std::size_t> reserved;
+
+  void reserve(std::size_t size)
+  {
+    reserved.push_back(size);
+    std::vector<int>::reserve(size);
+  }
+};
+
+TEST_CASE("containers", "[poafloc/parser]")
+{
+  struct arguments
+  {
+    tracked numbers;
+    std::deque<std::string> names;
+    std::set<int> unique;
+    std::vector<std::string> files;
+    std::string last;
+  } args;
+
+  auto program = parser<arguments> {
+      positional {
+          argument_list {"files", &arguments::files},
+      },
+      group {
+          "unnamed",
+          list {"n numbers", &arguments::numbers, "NUM Numbers"},
+          list {"a names", &arguments::names, "NAME Names"},
+          direct {"u unique", &arguments::unique, "NUM Unique"},
+          list {"l last", &arguments::last, "NAME Last one"},
+      },
+  };
+
+  SECTION("reserved once per run")
+  {
+    std::vector<std::string_view> cmdline = {
+        "test", "-n", "1", "2", "3", "-a", "x", "--numbers", "4", "5", "--", "f"
+    };
+    REQUIRE_NOTHROW(program(args, cmdline));
+    REQUIRE(args.numbers == std::vector<int> {1, 2, 3, 4, 5});
+    REQUIRE(args.numbers.reserved == std::vector<std::size_t> {3, 6});
+    REQUIRE(args.names == std::deque<std::string> {"x"});
+    REQUIRE(args.files == std::vector<std::string> {"f"});
+  }
+
+  SECTION("repeated short runs")
+  {
+    std::vector<std::string> cmdline = {"test"};
+    for (int i = 0; i < 1000; i++) {
+      cmdline.emplace_back("-n");
+      cmdline.push_back(std::to_string(i));
+    }
+    cmdline.emplace_back("--");
+    cmdline.emplace_back("f");
+    REQUIRE_NOTHROW(program(args, cmdline));
+    REQUIRE(std::size(args.numbers) == 1000);
+    REQUIRE(args.numbers[999] == 999);
+
+    // capacity doubles, instead of growing by one on every run
+    REQUIRE(std::size(args.numbers.reserved) == 11);
+    REQUIRE(args.numbers.reserved.back() == 1024);
+  }
+
+  SECTION("positional list")
+  {
+    std::vector<std::string> cmdline = {"test", "-a", "x", "--", "f", "-g"};
+    cmdline.insert(cmdline.end(), 100, "h");
+    REQUIRE_NOTHROW(program(args, cmdline));
+    REQUIRE(std::size(args.files) == 102);
+    REQUIRE(args.files.capacity() == 102);
+    REQUIRE(args.files[1] == "-g");
+  }
+
+  SECTION("set and repeated direct")
+  {
+    std::vector<std::string_view> cmdline = {
+        "test", "-u", "3", "-u1", "--unique=3", "-l", "a", "b", "--", "f"
+    };
+    REQUIRE_NOTHROW(program(args, cmdline));
+    REQUIRE(args.unique == std::set<int> {1, 3});
+    REQUIRE(args.last == "b");
+  }
+
+  SECTION("invalid element")
+  {
+    std::vector<std::string_view> cmdline = {"test", "-n", "1", "x", "--", "f"};
+    REQUIRE_THROWS_AS(
+        program(args, cmdline), error<error_code::invalid_argument>
+    );
+    REQUIRE(args.numbers == std::vector<int> {1});
+  }
+
+  SECTION("streamed")
+  {
+    std::vector<std::string_view> cmdline = {"test", "-n", "1", "2", "--", "f"};
+    auto streamed =
+        cmdline | std::views::filter([](auto /*arg*/) { return true; });
+    REQUIRE_NOTHROW(program(args, streamed));
+    REQUIRE(args.numbers == std::vector<int> {1, 2});
+    REQUIRE(args.numbers.reserved.empty());
+  }
+}
+
 TEST_CASE("positional", "[poafloc/parser]")
 {
   struct arguments
@@ -798,4 +1023,374 @@ TEST_CASE("multiple", "[poafloc/parser]")
   }
 }
 
+TEST_CASE("try_parse", "[poafloc/parser]")
+{
+  struct arguments
+  {
+    bool flag = false;
+    int value = 0;
+    std::string name;
+    std::string one;
+  } args;
+
+  auto program = parser<arguments> {
+      positional {
+          argument {"one", &arguments::one},
+      },
+      group {
+          "unnamed",
+          boolean {"f flag", &arguments::flag, "something"},
+          direct {"v value", &arguments::value, "NUM something"},
+          direct {"n name", &arguments::name, "NAME something"},
+      },
+  };
+
+  const auto failure = [&](std::vector<std::string_view> cmdline)
+  {
+    const auto res = program.try_parse(args, cmdline);
+    REQUIRE(!res.has_value());
+    return res.error();
+  };
+
+  SECTION("valid")
+  {
+    std::vector<std::string_view> cmdline = {"test", "-f", "--value=3", "one"};
+    REQUIRE(program.try_parse(args, cmdline).has_value());
+    REQUIRE(args.flag == true);
+    REQUIRE(args.value == 3);
+    REQUIRE(args.one == "one");
+  }
+
+  SECTION("empty")
+  {
+    const auto err = failure({});
+    REQUIRE(err.code == error_code::empty);
+  }
+
+  SECTION("unknown short")
+  {
+    const auto err = failure({"test", "-f", "-fx", "one"});
+    REQUIRE(err.code == error_code::unknown_option);
+    REQUIRE(err.index == 2);
+    REQUIRE(err.token == "x");
+  }
+
+  SECTION("invalid long")
+  {
+    const auto err = failure({"test", "--Value=3", "one"});
+    REQUIRE(err.code == error_code::invalid_option);
+    REQUIRE(err.index == 1);
+    REQUIRE(err.token == "Value");
+  }
+
+  SECTION("missing argument")
+  {
+    const auto err = failure({"test", "--name", "-f", "one"});
+    REQUIRE(err.code == error_code::missing_argument);
+    REQUIRE(err.index == 1);
+    REQUIRE(err.token == "name");
+  }
+
+  SECTION("superfluous argument")
+  {
+    const auto err = failure({"test", "--flag=1", "one"});
+    REQUIRE(err.code == error_code::superfluous_argument);
+    REQUIRE(err.index == 1);
+    REQUIRE(err.token == "flag");
+  }
+
+  SECTION("invalid value")
+  {
+    const auto err = failure({"test", "-f", "-v", "3x", "one"});
+    REQUIRE(err.code == error_code::invalid_argument);
+    REQUIRE(err.index == 3);
+    REQUIRE(err.token == "3x");
+  }
+
+  SECTION("value out of range")
+  {
+    const auto err = failure({"test", "-v99999999999", "one"});
+    REQUIRE(err.code == error_code::out_of_range);
+    REQUIRE(err.index == 1);
+    REQUIRE(err.token == "99999999999");
+  }
+
+  SECTION("positional")
+  {
+    const auto err = failure({"test", "one", "-f"});
+    REQUIRE(err.code == error_code::invalid_positional);
+    REQUIRE(err.index == 2);
+    REQUIRE(err.token == "-f");
+  }
+
+  SECTION("superfluous positional")
+  {
+    const auto err = failure({"test", "one", "two"});
+    REQUIRE(err.code == error_code::superfluous_positional);
+    REQUIRE(err.index == 2);
+    REQUIRE(err.token == "two");
+  }
+
+  SECTION("missing positional")
+  {
+    const auto err = failure({"test", "-f"});
+    REQUIRE(err.code == error_code::missing_positional);
+    REQUIRE(err.index == 2);
+  }
+
+  SECTION("argv")
+  {
+    std::vector<const char*> argv = {"test", "--value", "x"};
+    const auto res = program.try_parse(
+        args, static_cast<int>(std::size(argv)), argv.data()
+    );
+    REQUIRE(!res.has_value());
+    REQUIRE(res.error().code == error_code::invalid_argument);
+    REQUIRE(res.error().index == 2);
+    REQUIRE(res.error().token == "x");
+  }
+}
+
+template<class Parser, class Record, class Args>
+concept CanTryParse =
+    requires(const Parser& program, Record& rec, Args&& args) {
+      program.try_parse(rec, std::forward<Args>(args));
+    };
+
+TEST_CASE("ranges", "[poafloc/parser]")
+{
+  struct arguments
+  {
+    void add(std::string_view value) { list.emplace_back(value); }
+
+    bool flag = false;
+    std::vector<std::string> list;
+    std::string one;
+  } args;
+
+  auto program = parser<arguments> {
+      positional {
+          argument {"one", &arguments::one},
+      },
+      group {
+          "unnamed",
+          boolean {"f flag", &arguments::flag, "something"},
+          list {"l list", &arguments::add, "NAME something"},
+      },
+  };
+
+  SECTION("strings")
+  {
+    const std::vector<std::string> cmdline = {
+        "test", "-l", "a", "b", "-f", "one"
+    };
+    REQUIRE(program.try_parse(args, cmdline).has_value());
+    REQUIRE(args.flag == true);
+    REQUIRE(args.list == std::vector<std::string> {"a", "b"});
+    REQUIRE(args.one == "one");
+  }
+
+  SECTION("mutable argv")
+  {
+    std::string test = "test";
+    std::string opt = "--list";
+    std::string value = "a";
+    std::string flag = "-f";
+    std::string pos = "one";
+    std::vector<char*> argv = {
+        test.data(), opt.data(), value.data(), flag.data(), pos.data()
+    };
+    program(args, std::span(argv));
+    REQUIRE(args.flag == true);
+    REQUIRE(args.list == std::vector<std::string> {"a"});
+    REQUIRE(args.one == "one");
+  }
+
+  SECTION("temporaries")
+  {
+    // the strings would be gone before the error token is read
+    using program_type = decltype(program);
+    using strings = std::vector<std::string>;
+    STATIC_REQUIRE(!CanTryParse<program_type, arguments, strings>);
+    STATIC_REQUIRE(CanTryParse<program_type, arguments, const strings&>);
+    STATIC_REQUIRE(
+        CanTryParse<program_type, arguments, std::span<std::string>>
+    );
+    STATIC_REQUIRE(
+        !std::is_invocable_v<const program_type&, arguments&, strings>
+    );
+    STATIC_REQUIRE(
+        std::is_invocable_v<const program_type&, arguments&, strings&>
+    );
+  }
+
+  SECTION("error token")
+  {
+    const std::vector<std::string> cmdline = {"test", "-fx", "one"};
+    const auto res = program.try_parse(args, cmdline);
+    REQUIRE(!res.has_value());
+    REQUIRE(res.error().code == error_code::unknown_option);
+    REQUIRE(res.error().index == 1);
+    REQUIRE(res.error().token.data() == cmdline[1].data() + 2);
+  }
+
+  SECTION("missing argument at end")
+  {
+    const std::vector<std::string> cmdline = {"test", "one", "-l"};
+    const auto res = program.try_parse(args, cmdline);
+    REQUIRE(!res.has_value());
+    REQUIRE(res.error().code == error_code::invalid_positional);
+  }
+
+  SECTION("missing argument before option")
+  {
+    const std::vector<std::string> cmdline = {"test", "-l", "-f", "one"};
+    const auto res = program.try_parse(args, cmdline);
+    REQUIRE(!res.has_value());
+    REQUIRE(res.error().code == error_code::missing_argument);
+    REQUIRE(res.error().index == 1);
+    REQUIRE(res.error().token == "l");
+  }
+}
+
+TEST_CASE("session", "[poafloc/parser]")
+{
+  struct arguments
+  {
+    void add(std::string_view value) { list.emplace_back(value); }
+
+    bool flag = false;
+    std::vector<std::string> list;
+    std::string one;
+    std::string name;
+  } args;
+
+  auto program = parser<arguments> {
+      positional {
+          argument {"one", &arguments::one},
+      },
+      group {
+          "unnamed",
+          boolean {"f flag", &arguments::flag, "something"},
+          list {"l list", &arguments::add, "NAME something"},
+          direct {"n name", &arguments::name, "NAME something"},
+      },
+  };
+
+  parse_session session(program, args);
+
+  // copies and moves would keep viewing into the strings of the original
+  STATIC_REQUIRE(!std::is_copy_constructible_v<decltype(session)>);
+  STATIC_REQUIRE(!std::is_move_constructible_v<decltype(session)>);
+  STATIC_REQUIRE(!std::is_copy_assignable_v<decltype(session)>);
+  STATIC_REQUIRE(!std::is_move_assignable_v<decltype(session)>);
+
+  // every argument goes through the same buffer, as read from a pipe
+  std::string buffer;
+  const auto feed = [&](std::string_view arg)
+  {
+    buffer = arg;
+    return session.feed(buffer);
+  };
+
+  SECTION("one by one")
+  {
+    REQUIRE(feed("test").has_value());
+    REQUIRE(feed("--name").has_value());
+    REQUIRE(feed("value").has_value());
+    REQUIRE(feed("-l").has_value());
+    REQUIRE(feed("a").has_value());
+    REQUIRE(feed("b").has_value());
+    REQUIRE(feed("-f").has_value());
+    REQUIRE(feed("one").has_value());
+    REQUIRE(session.finish().has_value());
+    REQUIRE(args.name == "value");
+    REQUIRE(args.list == std::vector<std::string> {"a", "b"});
+    REQUIRE(args.flag == true);
+    REQUIRE(args.one == "one");
+  }
+
+  SECTION("chunks")
+  {
+    const std::vector<std::string> first = {"test", "-fn"};
+    const std::vector<std::string_view> second = {"value", "one"};
+    REQUIRE(session.feed(first).has_value());
+    REQUIRE(session.feed(second).has_value());
+    REQUIRE(session.finish().has_value());
+    REQUIRE(args.flag == true);
+    REQUIRE(args.name == "value");
+    REQUIRE(args.one == "one");
+  }
+
+  SECTION("missing argument")
+  {
+    REQUIRE(feed("test").has_value());
+    REQUIRE(feed("--name").has_value());
+    buffer = "overwritten";
+
+    const auto res = session.finish();
+    REQUIRE(!res.has_value());
+    REQUIRE(res.error().code == error_code::missing_argument);
+    REQUIRE(res.error().index == 1);
+    REQUIRE(res.error().token == "name");
+  }
+
+  SECTION("missing positional")
+  {
+    REQUIRE(feed("test").has_value());
+    REQUIRE(feed("-f").has_value());
+
+    const auto res = session.finish();
+    REQUIRE(!res.has_value());
+    REQUIRE(res.error().code == error_code::missing_positional);
+  }
+
+  SECTION("error persists")
+  {
+    REQUIRE(feed("test").has_value());
+    REQUIRE(!feed("-x").has_value());
+    buffer = "overwritten";
+
+    REQUIRE(!feed("one").has_value());
+    const auto res = session.finish();
+    REQUIRE(!res.has_value());
+    REQUIRE(res.error().code == error_code::unknown_option);
+    REQUIRE(res.error().index == 1);
+    REQUIRE(res.error().token == "x");
+    REQUIRE(args.one.empty());
+  }
+
+  SECTION("buffer reused")
+  {
+    // owned members keep their values, views see the buffer overwritten
+    struct views
+    {
+      std::string name;
+      std::string_view other;
+    } rec;
+
+    const auto viewing = parser<views> {
+        group {
+            "unnamed",
+            direct {"n name", &views::name, "NAME something"},
+            direct {"o other", &views::other, "NAME something"},
+        },
+    };
+
+    parse_session reused(viewing, rec);
+    std::string line;
+    for (const auto* arg : {"test", "--name", "first", "-o", "second"}) {
+      line = arg;
+      REQUIRE(reused.feed(line).has_value());
+    }
+    REQUIRE(reused.finish().has_value());
+    REQUIRE(rec.name == "first");
+    REQUIRE(rec.other == "second");
+
+    line = "third!";
+    REQUIRE(rec.name == "first");
+    REQUIRE(rec.other.data() == line.data());
+  }
+}
+
 // NOLINTEND(*complexity*)
@@ -0,0 +1,185 @@
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "poafloc/response.hpp"
+
+#include "poafloc/error.hpp"
+#include "poafloc/poafloc.hpp"
+
+using namespace poafloc;  // NOLINT
+
+namespace
+{
+
+// files of a test, removed when it is done
+class temp_dir
+{
+  std::filesystem::path m_path;
+
+public:
+  temp_dir()
+      : m_path(std::filesystem::temp_directory_path() / "poafloc-response")
+  {
+    std::filesystem::create_directories(m_path);
+  }
+
+  temp_dir(const temp_dir&) = delete;
+  temp_dir(temp_dir&&) = delete;
+  temp_dir& operator=(const temp_dir&) = delete;
+  temp_dir& operator=(temp_dir&&) = delete;
+
+  ~temp_dir() { std::filesystem::remove_all(m_path); }
+
+  // name of the file, with the @ in front
+  [[nodiscard]] std::string write(
+      const std::string& name, std::string_view text
+  ) const
+  {
+    const auto path = m_path / name;
+    std::ofstream(path, std::ios::binary) << text;
+    return "@" + path.string();
+  }
+};
+
+using word_list = std::vector<std::string>;
+
+word_list expand(response_files& files, const std::vector<std::string>& args)
+{
+  const std::vector<std::string_view> views(args.begin(), args.end());
+  const auto res = files.expand(views);
+  return {res.begin(), res.end()};
+}
+
+}  // namespace
+
+// NOLINTBEGIN(*complexity*)
+TEST_CASE("expand", "[poafloc/response]")
+{
+  const temp_dir dir;
+  response_files files;
+
+  SECTION("none")
+  {
+    REQUIRE(
+        expand(files, {"prog", "-a", "b"}) == word_list {"prog", "-a", "b"}
+    );
+    REQUIRE(expand(files, {}).empty());
+  }
+
+  SECTION("words")
+  {
+    const auto file = dir.write("words", "-a 'b c'\n  --d=\"e\\\"f\"\n\\@g\n");
+    REQUIRE(
+        expand(files, {"prog", "x", file, "y"})
+        == word_list {"prog", "x", "-a", "b c", "--d=e\"f", "@g", "y"}
+    );
+  }
+
+  SECTION("in place")
+  {
+    const std::string text = "one two";
+    const auto file = dir.write("in_place", text);
+    const std::vector<std::string_view> args = {"prog", file};
+
+    const auto res = files.expand(args);
+    REQUIRE(std::size(res) == 3);
+    REQUIRE(res[2].data() == res[1].data() + 4);
+  }
+
+  SECTION("program name")
+  {
+    const auto file = dir.write("program", "a");
+    REQUIRE(expand(files, {file, file}) == word_list {file, "a"});
+  }
+
+  SECTION("nested")
+  {
+    const auto inner = dir.write("inner", "b c");
+    const auto outer = dir.write("outer", "a " + inner + " d " + inner);
+    REQUIRE(
+        expand(files, {"prog", outer, "e"})
+        == word_list {"prog", "a", "b", "c", "d", "b", "c", "e"}
+    );
+  }
+
+  SECTION("deeply nested")
+  {
+    const auto last = dir.write("last", "c");
+    const auto middle = dir.write("middle", "b " + last + " " + last + " y");
+    const auto first = dir.write("first", middle + " z");
+    REQUIRE(
+        expand(files, {"prog", "a", first, first})
+        == word_list {
+            "prog", "a", "b", "c", "c", "y", "z", "b", "c", "c", "y", "z"
+        }
+    );
+  }
+
+  SECTION("empty")
+  {
+    const auto file = dir.write("empty", "");
+    const auto blank = dir.write("blank", " \n\t");
+    REQUIRE(
+        expand(files, {"prog", file, blank, "a"}) == word_list {"prog", "a"}
+    );
+  }
+
+  SECTION("missing")
+  {
+    REQUIRE(
+        expand(files, {"prog", "@/nonexistent/file", "@"})
+        == word_list {"prog", "@/nonexistent/file", "@"}
+    );
+  }
+
+  SECTION("recursive")
+  {
+    const auto self = dir.write("self", "");
+    (void)dir.write("self", "a " + self);
+    REQUIRE_THROWS_AS(
+        expand(files, {"prog", self}), error<error_code::recursive_response>
+    );
+
+    const auto other = dir.write("other", "");
+    const auto loop = dir.write("loop", "a " + other);
+    (void)dir.write("other", "b " + loop);
+    REQUIRE_THROWS_AS(
+        expand(files, {"prog", loop}), error<error_code::recursive_response>
+    );
+  }
+
+  SECTION("parsed")
+  {
+    struct arguments
+    {
+      std::string name;
+      std::vector<std::string> rest;
+
+      void add(std::string_view value) { rest.emplace_back(value); }
+    } args;
+
+    const auto program = parser<arguments> {
+        positional {
+            argument_list {"rest", &arguments::add},
+        },
+        group {
+            "unnamed",
+            direct {"n name", &arguments::name, "NAME something"},
+        },
+    };
+
+    const auto file = dir.write("parsed", "--name 'a b' x.o y.o");
+    const std::vector<const char*> argv = {"prog", file.c_str(), "z.o"};
+    const auto argc = static_cast<int>(std::size(argv));
+    program(args, files.expand(argc, argv.data()));
+
+    REQUIRE(args.name == "a b");
+    REQUIRE(args.rest == word_list {"x.o", "y.o", "z.o"});
+  }
+}
+// NOLINTEND(*complexity*)
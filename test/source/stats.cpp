@@ -0,0 +1,96 @@
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "poafloc/error.hpp"
+#include "poafloc/poafloc.hpp"
+#include "poafloc/stats.hpp"
+
+#include "fixture.hpp"
+
+using namespace poafloc;  // NOLINT
+
+// NOLINTBEGIN(*complexity*, *magic*)
+TEST_CASE("stats", "[poafloc/stats]")
+{
+  fixture::arguments args;
+  const auto program = fixture::make_program();
+
+  SECTION("counters")
+  {
+    const std::vector<std::string_view> line = {
+        "prog", "-vt4", "--out", "a.out", "--thr=2", "x.c", "y.c"
+    };
+    REQUIRE(program.try_parse(args, line).has_value());
+
+    const std::vector<std::string_view> bad = {"prog", "--threads", "many"};
+    REQUIRE(!program.try_parse(args, bad).has_value());
+
+    const auto stats = program.stats();
+    if constexpr (!instrumented) {
+      REQUIRE(stats.parses == 0);
+      REQUIRE(stats.arguments == 0);
+      REQUIRE(stats.lookup.count == 0);
+      return;
+    }
+
+    REQUIRE(stats.parses == 2);
+    REQUIRE(stats.arguments == 10);
+    REQUIRE(stats.short_clusters == 1);
+    REQUIRE(stats.long_options == 2);
+    REQUIRE(stats.long_values == 1);
+    REQUIRE(stats.values == 2);
+    REQUIRE(stats.abbreviations == 2);
+
+    REQUIRE(stats.lookup.count == 5);
+    REQUIRE(stats.conversion.count == 5);
+    REQUIRE(stats.positional.count == 2);
+
+    REQUIRE(stats.errors_of(error_code::invalid_argument) == 1);
+    REQUIRE(stats.errors_of(error_code::unknown_option) == 0);
+  }
+
+  SECTION("take")
+  {
+    const std::vector<std::string_view> line = {"prog", "--verbose", "x.c"};
+    REQUIRE(program.try_parse(args, line).has_value());
+    REQUIRE(program.try_parse(args, line).has_value());
+
+    const auto taken = program.take_stats();
+    REQUIRE(taken.parses == (instrumented ? 2 : 0));
+    REQUIRE(program.stats().parses == 0);
+
+    // copies of a parser add to the same totals
+    const auto copy = program;  // NOLINT(*unnecessary-copy*)
+    REQUIRE(copy.try_parse(args, line).has_value());
+    REQUIRE(program.stats().parses == (instrumented ? 1 : 0));
+  }
+
+  SECTION("session")
+  {
+    parse_session session(program, args);
+    REQUIRE(session.feed("prog").has_value());
+    REQUIRE(session.feed("--bogus").error().code == error_code::unknown_option);
+
+    const auto stats = program.stats();
+    REQUIRE(stats.parses == (instrumented ? 1 : 0));
+    REQUIRE(
+        stats.errors_of(error_code::unknown_option) == (instrumented ? 1 : 0)
+    );
+  }
+
+  SECTION("moved from")
+  {
+    auto moved = program;
+    const auto other = std::move(moved);
+    const std::vector<std::string_view> line = {"prog"};
+    // NOLINTNEXTLINE(*use-after-move*)
+    REQUIRE(moved.try_parse(args, line).has_value());
+    REQUIRE(moved.stats().parses == 0);
+    REQUIRE(other.stats().parses == 0);
+  }
+}
+// NOLINTEND(*complexity*, *magic*)
@@ -0,0 +1,156 @@
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "poafloc/tokenizer.hpp"
+
+#include "poafloc/error.hpp"
+#include "poafloc/poafloc.hpp"
+
+using namespace poafloc;  // NOLINT
+
+namespace
+{
+
+std::vector<std::string> split(std::string_view line)
+{
+  tokenizer tok;
+  const auto words = tok.split(line);
+  return {words.begin(), words.end()};
+}
+
+// word at idx is a view into line, nothing was copied for it
+bool in_place(std::string_view line, std::string_view word)
+{
+  const auto* begin = line.data();
+  const auto* end = line.data() + line.size();
+  return std::less_equal<>()(begin, word.data())
+      && std::less_equal<>()(word.data() + word.size(), end);
+}
+
+}  // namespace
+
+using word_list = std::vector<std::string>;
+
+// NOLINTBEGIN(*complexity*)
+TEST_CASE("blanks", "[poafloc/tokenizer]")
+{
+  REQUIRE(split("").empty());
+  REQUIRE(split(" \t\n ").empty());
+  REQUIRE(split("a") == word_list {"a"});
+  REQUIRE(
+      split("  prog -a\t--bee=c \n d  ")
+      == word_list {"prog", "-a", "--bee=c", "d"}
+  );
+}
+
+TEST_CASE("quotes", "[poafloc/tokenizer]")
+{
+  SECTION("single")
+  {
+    REQUIRE(
+        split(R"('a b' 'c\d' '"')") == word_list {"a b", R"(c\d)", "\""}
+    );
+  }
+
+  SECTION("double")
+  {
+    REQUIRE(
+        split(R"("a b" "\$\`\"\\" "\a")")
+        == word_list {"a b", R"($`"\)", R"(\a)"}
+    );
+  }
+
+  SECTION("empty")
+  {
+    REQUIRE(split(R"('' "" a'')") == word_list {"", "", "a"});
+  }
+
+  SECTION("adjacent")
+  {
+    REQUIRE(split(R"(a'b c'"d e"f)") == word_list {"ab cd ef"});
+    REQUIRE(split(R"(--name="a b")") == word_list {"--name=a b"});
+  }
+
+  SECTION("unterminated")
+  {
+    using unterminated = error<error_code::unterminated_quote>;
+    REQUIRE_THROWS_AS(split("a 'b c"), unterminated);
+    REQUIRE_THROWS_AS(split("a \"b c"), unterminated);
+    REQUIRE_THROWS_AS(split("a \"b c\\"), unterminated);
+  }
+}
+
+TEST_CASE("escapes", "[poafloc/tokenizer]")
+{
+  REQUIRE(split(R"(a\ b \'c \\)") == word_list {"a b", "'c", "\\"});
+  REQUIRE(split("a\\\nb \\\n c") == word_list {"ab", "c"});
+  REQUIRE(split("\"a\\\nb\"") == word_list {"ab"});
+  REQUIRE(split("a\\") == word_list {"a\\"});
+}
+
+TEST_CASE("in place", "[poafloc/tokenizer]")
+{
+  tokenizer tok;
+
+  SECTION("plain and quoted")
+  {
+    const std::string line = R"(prog -a "b c" 'd' e\ f)";
+    const auto words = tok.split(line);
+    REQUIRE(std::size(words) == 5);
+    REQUIRE(in_place(line, words[0]));
+    REQUIRE(in_place(line, words[1]));
+    REQUIRE(in_place(line, words[2]));
+    REQUIRE(in_place(line, words[3]));
+    REQUIRE(!in_place(line, words[4]));
+    REQUIRE(words[4] == "e f");
+  }
+
+  SECTION("scratch reused")
+  {
+    const std::string first = R"(a\ b c\ d e\ f)";
+    const auto words = tok.split(first);
+    REQUIRE(words[0] == "a b");
+    REQUIRE(words[1] == "c d");
+    REQUIRE(words[2] == "e f");
+
+    const std::string second = R"(g\ h)";
+    REQUIRE(tok.split(second)[0] == "g h");
+  }
+}
+
+TEST_CASE("tokenized", "[poafloc/tokenizer]")
+{
+  struct arguments
+  {
+    std::string name;
+    int value = 0;
+    std::string one;
+  } args;
+
+  const auto program = parser<arguments> {
+      positional {
+          argument {"one", &arguments::one},
+      },
+      group {
+          "unnamed",
+          direct {"n name", &arguments::name, "NAME something"},
+          direct {"v value", &arguments::value, "NUM something"},
+      },
+  };
+
+  tokenizer tok;
+  program(args, tok.split(R"(test --name "a b" -v 3 'one two')"));
+  REQUIRE(args.name == "a b");
+  REQUIRE(args.value == 3);
+  REQUIRE(args.one == "one two");
+
+  const auto res = program.try_parse(args, tok.split("test -v x one"));
+  REQUIRE(!res.has_value());
+  REQUIRE(res.error().code == error_code::invalid_argument);
+  REQUIRE(res.error().token == "x");
+}
+// NOLINTEND(*complexity*)
@@ -0,0 +1,126 @@
+#include <array>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "poafloc/error.hpp"
+#include "poafloc/poafloc.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#  include <unistd.h>
+#endif
+
+using namespace poafloc;  // NOLINT
+
+// NOLINTBEGIN(*complexity*)
+TEST_CASE("usage", "[poafloc/usage]")
+{
+  struct arguments
+  {
+    bool flag = false;
+    std::string name;
+    std::vector<std::string> rest;
+
+    void add(std::string_view value) { rest.emplace_back(value); }
+  };
+
+  const auto program = parser<arguments> {
+      positional {
+          argument_list {"rest", &arguments::add},
+      },
+      group {
+          "unnamed",
+          boolean {"f flag", &arguments::flag, "something"},
+          direct {"n name", &arguments::name, "NAME Name to use"},
+      },
+  };
+
+  SECTION("help")
+  {
+    const auto text = program.help_text("prog");
+    REQUIRE(text.starts_with("Usage: prog [OPTIONS] rest...\n\nunnamed:\n"));
+    REQUIRE(
+        text.find("  -n, --name=NAME             Name to use\n")
+        != std::string_view::npos
+    );
+    REQUIRE(text.find("Informational Options:") != std::string_view::npos);
+    REQUIRE(text.ends_with("\n\n"));
+  }
+
+  SECTION("usage")
+  {
+    const auto text = program.usage_text("prog");
+    REQUIRE(text.starts_with("Usage: prog [-?f] [-n NAME]"));
+    REQUIRE(text.find("[--name=NAME]") != std::string_view::npos);
+    REQUIRE(text.ends_with("rest...\n\n"));
+  }
+
+  SECTION("rendered once")
+  {
+    const auto first = program.help_text("prog");
+    const std::string program_name = "prog";
+    REQUIRE(program.help_text(program_name).data() == first.data());
+    REQUIRE(program.usage_text("prog").data() != first.data());
+    REQUIRE(program.usage_text("prog").data()
+            == program.usage_text(program_name).data());
+  }
+
+  SECTION("program names")
+  {
+    const auto first = program.help_text("first");
+    const auto second = program.help_text("second");
+    REQUIRE(first.starts_with("Usage: first "));
+    REQUIRE(second.starts_with("Usage: second "));
+    REQUIRE(program.help_text("first").data() == first.data());
+  }
+
+  SECTION("names past the cache")
+  {
+    for (int i = 0; i < 16; i++) {
+      const auto name = "prog" + std::to_string(i);
+      REQUIRE(program.help_text(name).starts_with("Usage: " + name + " "));
+      REQUIRE(program.usage_text(name).starts_with("Usage: " + name + " "));
+    }
+    const auto first = program.help_text("prog0");
+    REQUIRE(program.help_text("prog0").data() == first.data());
+  }
+
+  SECTION("moved from")
+  {
+    auto moved = program;
+    const auto other = std::move(moved);
+    // NOLINTNEXTLINE(*use-after-move*)
+    REQUIRE(moved.help_text("prog").starts_with("Usage: prog "));
+    REQUIRE(moved.usage_text("prog").starts_with("Usage: prog"));
+    REQUIRE(other.help_text("prog").starts_with("Usage: prog "));
+  }
+
+#if defined(__unix__) || defined(__APPLE__)
+  SECTION("write")
+  {
+    std::array<int, 2> fds = {};
+    REQUIRE(::pipe(fds.data()) == 0);
+
+    REQUIRE(program.write_usage(fds[1], "prog"));
+    ::close(fds[1]);
+
+    std::string read;
+    std::array<char, 256> buffer = {};
+    while (true) {
+      const auto res = ::read(fds[0], buffer.data(), std::size(buffer));
+      if (res <= 0) {
+        break;
+      }
+      read.append(buffer.data(), static_cast<std::size_t>(res));
+    }
+    ::close(fds[0]);
+
+    REQUIRE(read == program.usage_text("prog"));
+    REQUIRE(!program.write_usage(fds[1], "prog"));
+  }
+#endif
+}
+// NOLINTEND(*complexity*)